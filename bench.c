@@ -0,0 +1,279 @@
+// headless benchmark of the simulation
+// builds shooter.c natively (see native.h) and runs tick
+// with a fixed delta over synthetic scenes,
+// timing every system separately
+//
+//   ./build_native.sh
+//   ./shooter_bench [max_entities] [max_ticks] [scene] [threads] [system_threads]
+//   ./shooter_bench replay recording
+//   ./shooter_bench check
+//
+// scenes are run at 100, 1000, ... up to max_entities
+// threads is for the ball collisions, system_threads runs the systems
+// on a thread pool, 0 is one per core for both
+// replay runs a recording (see `start_recording`) tick by tick,
+// and says if the world came out different
+// check runs scenes that went wrong before, and fails if they still do
+
+#define SHOOTER_NO_MAIN
+#include "shooter.c"
+
+#define BENCH_WORLD_SIZE 100000
+#define BENCH_WARMUP_TICKS 2
+#define BENCH_MIN_TICKS 3
+#define BENCH_TIME_BUDGET 1.0
+
+double bench_now() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1000000000.0;
+}
+float bench_random(float min, float max) {
+    return min + (max - min) * ((float)rand() / RAND_MAX);
+}
+
+// empties every table and puts the player back in the middle,
+// with no waves, so the scene only has what we add to it
+void bench_reset_world() {
+    clear_table(proximity_attack);
+    clear_table(hit_feedback_table);
+    clear_collision_table();
+    clear_table(physics_states);
+    clear_table(physics_balls);
+    clear_table(sprite_map);
+    clear_table(ai_enemy);
+    clear_table(bullets);
+    clear_table(health_table);
+    for (table_id_t i = 0; i < entity_table->curr_max; i += 1) {
+        entity_table->used[i] = false;
+    }
+    entity_table->curr_max = 0;
+    entity_table->first_free = NO_FREE_ITEM;
+    command_buffer->count = 0;
+    reset_timer_wheel();
+    reset_weapon_states();
+
+    memset(input_state, 0, sizeof(struct Input_State));
+    create_player(BENCH_WORLD_SIZE / 2.0, BENCH_WORLD_SIZE / 2.0);
+    // the player never dies, so step_player keeps running
+    health_table->health_points[0] = 1e30;
+
+    memset(&wave_emitter.remaining, 0, sizeof(wave_emitter.remaining));
+    // never completes, so no new waves start
+    wave_completion.remaining[ENEMY_PLAIN] = 255;
+    wave_rest.rest_state = -0.01;
+    score = 0;
+}
+
+// zombies in a ring around the player, about as dense as a real wave
+void bench_scene_zombies(size_t count) {
+    const float center = BENCH_WORLD_SIZE / 2.0;
+    const float outer = 200 + sqrtf(count) * AI_ENEMY_PREFERRED_DISTANCE;
+    for (size_t i = 0; i < count; i += 1) {
+        const float angle = bench_random(0, 2 * M_PI);
+        const float distance = bench_random(200, outer);
+        create_zombie(center + cosf(angle) * distance,
+                      center + sinf(angle) * distance);
+    }
+}
+// bullets flying away from the player in every direction
+void bench_scene_bullets(size_t count) {
+    const float center = BENCH_WORLD_SIZE / 2.0;
+    const float outer = 50 + sqrtf(count) * 10;
+    for (size_t i = 0; i < count; i += 1) {
+        const float angle = bench_random(0, 2 * M_PI);
+        const float distance = bench_random(50, outer);
+        create_bullet(center + cosf(angle) * distance,
+                      center + sinf(angle) * distance,
+                      cosf(angle) * BULLET_SPEED,
+                      sinf(angle) * BULLET_SPEED);
+    }
+}
+// zombies packed much closer than their radius,
+// the worst case for the broadphase and the collision table
+void bench_scene_cluster(size_t count) {
+    const float center = BENCH_WORLD_SIZE / 2.0;
+    const float outer = sqrtf(count) * 8;
+    for (size_t i = 0; i < count; i += 1) {
+        const float angle = bench_random(0, 2 * M_PI);
+        const float distance = bench_random(0, outer);
+        create_zombie(center + 300 + cosf(angle) * distance,
+                      center + sinf(angle) * distance);
+    }
+}
+
+struct Bench_Scene {
+    const char* name;
+    void (*create)(size_t count);
+};
+struct Bench_Scene bench_scenes[] = {
+    {"zombies", &bench_scene_zombies},
+    {"bullets", &bench_scene_bullets},
+    {"cluster", &bench_scene_cluster},
+};
+#define BENCH_SCENE_COUNT (sizeof(bench_scenes) / sizeof(struct Bench_Scene))
+
+void bench_print(const double* system_time, size_t entity_count, size_t tick_count) {
+    printf("%-20s %14s %12s\n", "system", "ns/tick", "ns/entity");
+    double total = 0;
+    for (size_t system = 0; system < SYSTEM_COUNT; system += 1) {
+        const double ns_per_tick = system_time[system] * 1e6 / tick_count;
+        total += ns_per_tick;
+        printf("%-20s %14.0f %12.2f\n", system_names[system],
+               ns_per_tick, ns_per_tick / entity_count);
+    }
+    printf("%-20s %14.0f %12.2f\n", "total", total, total / entity_count);
+}
+
+void bench_run(struct Bench_Scene* scene, size_t count, size_t max_ticks) {
+    srand(1);
+    bench_reset_world();
+    scene->create(count);
+    const size_t entity_count = physics_states->curr_max;
+
+    const float delta = 1.0 / TICK_RATE;
+    for (size_t t = 0; t < BENCH_WARMUP_TICKS; t += 1) {
+        tick(delta);
+    }
+
+    // tick times every system into the profile ring buffer,
+    // with system threads, the systems that run side by side add up to more than the tick
+    // we add up each sample right after it's taken
+    double system_time[SYSTEM_COUNT] = {0};
+    size_t tick_count = 0;
+    const double bench_start = bench_now();
+    while (tick_count < max_ticks) {
+        const uint sample = profile_data->next_sample;
+        tick(delta);
+        for (size_t system = 0; system < SYSTEM_COUNT; system += 1) {
+            system_time[system] += profile_data->system_time[sample * SYSTEM_COUNT + system];
+        }
+        tick_count += 1;
+        if (tick_count >= BENCH_MIN_TICKS &&
+            bench_now() - bench_start > BENCH_TIME_BUDGET) {
+            break;
+        }
+    }
+
+    printf("\n%s, %zu entities, %zu ticks\n", scene->name, entity_count, tick_count);
+    bench_print(system_time, entity_count, tick_count);
+}
+
+// a recorded session as a workload, every tick of it
+void bench_replay(const char* path) {
+    if (!start_replay(path)) {
+        printf("can't replay %s\n", path);
+        return;
+    }
+    const size_t entity_count = physics_states->curr_max;
+    double system_time[SYSTEM_COUNT] = {0};
+    size_t tick_count = 0;
+    while (true) {
+        const uint sample = profile_data->next_sample;
+        if (!replay_tick()) {
+            break;
+        }
+        for (size_t system = 0; system < SYSTEM_COUNT; system += 1) {
+            system_time[system] += profile_data->system_time[sample * SYSTEM_COUNT + system];
+        }
+        tick_count += 1;
+    }
+    printf("\n%s, %zu entities at the start, %zu ticks\n", path, entity_count, tick_count);
+    if (tick_count > 0) {
+        bench_print(system_time, entity_count, tick_count);
+    }
+    if (get_replay_divergent_tick() < 0) {
+        printf("checksum %016llx, same as recorded\n", (unsigned long long)recorder.checksum);
+    }
+    else {
+        printf("checksum %016llx, diverged at tick %d\n", (unsigned long long)recorder.checksum,
+               get_replay_divergent_tick());
+    }
+}
+
+// a zombie killed while it flashes, and a new one hit in its slot,
+// the hit feedback table has to empty once the flashes end
+bool bench_check_hit_feedback() {
+    bench_reset_world();
+    const float delta = 1.0 / TICK_RATE;
+    const table_id_t zombie = create_zombie(10, 10);
+    add_hit_feedback_item(zombie, 100);
+    queue_command(COMMAND_DESTROY_ZOMBIE, zombie);
+    flush_commands();
+    const table_id_t next_zombie = create_zombie(10, 10);
+    if (get_entity_slot(next_zombie) != get_entity_slot(zombie)) {
+        printf("hit feedback: the slot wasn't reused\n");
+        return false;
+    }
+    add_hit_feedback_item(next_zombie, 100);
+    // the flash lasts 100 / HIT_FEEDBACK_SPEED seconds
+    for (size_t t = 0; t < TICK_RATE; t += 1) {
+        tick(delta);
+    }
+    if (hit_feedback_table->curr_max != 0) {
+        printf("hit feedback: %zu items left\n", hit_feedback_table->curr_max);
+        return false;
+    }
+    return true;
+}
+int bench_check() {
+    if (!init(BENCH_WORLD_SIZE, BENCH_WORLD_SIZE, 0)) {
+        printf("no memory for the world\n");
+        return 1;
+    }
+    bool ok = true;
+    ok = bench_check_hit_feedback() && ok;
+    printf("%s\n", ok ? "all checks passed" : "checks failed");
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "check") == 0) {
+        return bench_check();
+    }
+    if (argc > 2 && strcmp(argv[1], "replay") == 0) {
+        // the recording brings its own world
+        if (!init(BENCH_WORLD_SIZE, BENCH_WORLD_SIZE, 0)) {
+            printf("no memory for the world\n");
+            return 1;
+        }
+        bench_replay(argv[2]);
+        return 0;
+    }
+    size_t max_entities = 10000;
+    size_t max_ticks = 120;
+    const char* scene_name = NULL;
+    if (argc > 1) {
+        max_entities = strtoul(argv[1], NULL, 10);
+    }
+    if (argc > 2) {
+        max_ticks = strtoul(argv[2], NULL, 10);
+    }
+    if (argc > 3 && strcmp(argv[3], "all") != 0) {
+        scene_name = argv[3];
+    }
+    // one entity is the player
+    if (!init(BENCH_WORLD_SIZE, BENCH_WORLD_SIZE, max_entities + 1)) {
+        printf("no memory for %zu entities\n", max_entities);
+        return 1;
+    }
+    if (argc > 4) {
+        set_physics_thread_count(strtoul(argv[4], NULL, 10));
+    }
+    if (argc > 5) {
+        set_system_thread_count(strtoul(argv[5], NULL, 10));
+    }
+
+    printf("simd width %d, physics threads %u, system threads %u, max entity count %zu, arena %zu bytes\n",
+           SIMD_WIDTH, get_physics_thread_count(), get_system_thread_count(),
+           max_entity_count, get_arena_size());
+    for (size_t s = 0; s < BENCH_SCENE_COUNT; s += 1) {
+        if (scene_name != NULL && strcmp(scene_name, bench_scenes[s].name) != 0) {
+            continue;
+        }
+        for (size_t count = 100; count <= max_entities; count *= 10) {
+            bench_run(&bench_scenes[s], count, max_ticks);
+        }
+    }
+    return 0;
+}
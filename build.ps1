@@ -1 +1 @@
-emcc shooter.c -o shooter.js -O3 -s "EXTRA_EXPORTED_RUNTIME_METHODS=['ccall', 'cwrap']" -s "RESERVED_FUNCTION_POINTERS=1"
\ No newline at end of file
+emcc shooter.c -o shooter.js -msimd128 -O3 -s "EXTRA_EXPORTED_RUNTIME_METHODS=['ccall', 'cwrap']" -s "RESERVED_FUNCTION_POINTERS=1" -s "ALLOW_MEMORY_GROWTH=1"
\ No newline at end of file
@@ -1,2 +1,2 @@
 #!/bin/bash
-emcc shooter.c -o shooter.js -O0 -g4 -s "EXTRA_EXPORTED_RUNTIME_METHODS=['ccall', 'cwrap']" -s "RESERVED_FUNCTION_POINTERS=1" --source-map-base http://localhost:6931/
\ No newline at end of file
+emcc shooter.c -o shooter.js -msimd128 -O0 -g4 -s "EXTRA_EXPORTED_RUNTIME_METHODS=['ccall', 'cwrap']" -s "RESERVED_FUNCTION_POINTERS=1" -s "ALLOW_MEMORY_GROWTH=1" --source-map-base http://localhost:6931/
\ No newline at end of file
@@ -0,0 +1,2 @@
+#!/bin/bash
+cc bench.c -o shooter_bench -O3 -march=native -ffp-contract=off -DSHOOTER_THREADS -pthread -lm
@@ -6,10 +6,25 @@ const get_score = Module.cwrap('get_score');
 const start_time = Module.cwrap('start_time');
 const stop_time = Module.cwrap('stop_time');
 const set_screen_size = Module.cwrap('set_screen_size', null, ['number', 'number']);
-
-function find_item_index(table, entity_id) {
-    return Module.ccall('find_item_index', 'number', ['number', 'number'], [table.ptr, entity_id]);
-}
+const get_tick_interpolation = Module.cwrap('get_tick_interpolation', 'number');
+
+// every table starts with the fields of `struct Table`,
+// the concrete columns come after them
+// tables grow, which moves their columns,
+// so the table getters make new views on every call
+const TABLE_HEADER = 11;
+
+// bits of `enum Components`
+const COMPONENT_PHYSICS_STATE    = 1 << 0;
+const COMPONENT_PHYSICS_BALL     = 1 << 1;
+const COMPONENT_PROXIMITY_ATTACK = 1 << 2;
+const COMPONENT_HIT_FEEDBACK     = 1 << 3;
+const COMPONENT_SPRITE_MAP       = 1 << 4;
+const COMPONENT_AI_ENEMY         = 1 << 5;
+const COMPONENT_BULLET           = 1 << 6;
+const COMPONENT_HEALTH           = 1 << 7;
+// not a table, the entity is queued for destruction
+const COMPONENT_DYING            = 1 << 8;
 
 function get_overlay_data() {
     const ptr = Module.ccall('get_overlay_data', 'number');
@@ -17,7 +32,7 @@ function get_overlay_data() {
     const player_dead = Module.HEAP32[(ptr+4*0)>>2];
     const wave_start  = Module.HEAP32[(ptr+4*1)>>2];
     const wave_end    = Module.HEAP32[(ptr+4*2)>>2];
-    const wave_state  = Module.HEAP32[(ptr+4*3)>>2];
+    const wave_state  = Module.HEAPF32[(ptr+4*3)>>2];
 
     return {
         player_dead,
@@ -27,6 +42,14 @@ function get_overlay_data() {
         ptr,
     }
 }
+// reads into the object from get_overlay_data, so render allocates nothing
+function update_overlay_data(overlay_data) {
+    const ptr = overlay_data.ptr;
+    overlay_data.player_dead = Module.HEAP32[(ptr+4*0)>>2];
+    overlay_data.wave_start  = Module.HEAP32[(ptr+4*1)>>2];
+    overlay_data.wave_end    = Module.HEAP32[(ptr+4*2)>>2];
+    overlay_data.wave_state  = Module.HEAPF32[(ptr+4*3)>>2];
+}
 function get_weapon_states() {
     const ptr = Module.ccall('get_weapon_states', 'number');
 
@@ -43,19 +66,52 @@ function get_weapon_states() {
         ptr,
     }
 }
+function get_entity_table() {
+    const ptr = Module.ccall('get_entity_table', 'number');
+
+    const max_count      = Module.HEAP32[(ptr+4*0)>>2];
+    const ptr_used       = Module.HEAP32[(ptr+4*1)>>2];
+    const curr_max       = Module.HEAP32[(ptr+4*2)>>2];
+    const ptr_components = Module.HEAP32[(ptr+4*5)>>2];
+    const ptr_generation = Module.HEAP32[(ptr+4*6)>>2];
+
+    return {
+        max_count,
+        used:       new Uint8Array(Module.HEAPU8.buffer,   ptr_used,       max_count),
+        curr_max,
+        components: new Uint32Array(Module.HEAPU32.buffer, ptr_components, max_count),
+        generation: new Uint32Array(Module.HEAPU32.buffer, ptr_generation, max_count),
+        ptr,
+    };
+}
+// entity ids are handles, a slot in the entity table and a generation
+const ENTITY_SLOT_BITS = 18;
+const ENTITY_SLOT_MASK = (1 << ENTITY_SLOT_BITS) - 1;
+// false for ids of removed entities,
+// so ids and row indices cached between frames can be checked
+function is_entity_alive(entity_table, entity_id) {
+    const slot = entity_id & ENTITY_SLOT_MASK;
+    return slot < entity_table.curr_max &&
+           entity_table.used[slot] !== 0 &&
+           entity_table.generation[slot] === (entity_id >>> ENTITY_SLOT_BITS);
+}
+// true if the entity is in all the tables of the mask
+function has_components(entity_table, entity_id, components) {
+    return is_entity_alive(entity_table, entity_id) &&
+           (entity_table.components[entity_id & ENTITY_SLOT_MASK] & components) === components;
+}
 function get_collision_table() {
     const ptr = Module.ccall('get_collision_table', 'number');
 
     const max_count           = Module.HEAP32[(ptr+4*0)>>2];
-    const ptr_used            = Module.HEAP32[(ptr+4*1)>>2];
-    const curr_max            = Module.HEAP32[(ptr+4*2)>>2];
-    const ptr_entity_id       = Module.HEAP32[(ptr+4*3)>>2];
-    const ptr_entity_id_2     = Module.HEAP32[(ptr+4*4)>>2];
+    const count               = Module.HEAP32[(ptr+4*1)>>2];
+    const ptr_entity_id       = Module.HEAP32[(ptr+4*2)>>2];
+    const ptr_entity_id_2     = Module.HEAP32[(ptr+4*3)>>2];
 
+    // not a table, just this tick's pairs
     return {
         max_count,
-        used:            new Uint8Array(Module.HEAPU8.buffer,    ptr_used,        max_count),
-        curr_max,
+        count,
         entity_id:       new Uint32Array(Module.HEAPU32.buffer,  ptr_entity_id,   max_count),
         entity_id_2:     new Uint32Array(Module.HEAPU32.buffer,  ptr_entity_id_2, max_count),
         ptr,
@@ -68,7 +124,7 @@ function get_hit_feedback_table() {
     const ptr_used            = Module.HEAP32[(ptr+4*1)>>2];
     const curr_max            = Module.HEAP32[(ptr+4*2)>>2];
     const ptr_entity_id       = Module.HEAP32[(ptr+4*3)>>2];
-    const ptr_amount          = Module.HEAP32[(ptr+4*4)>>2];
+    const ptr_amount          = Module.HEAP32[(ptr+4*(TABLE_HEADER+0))>>2];
 
     return {
         max_count,
@@ -86,11 +142,11 @@ function get_sprite_map() {
     const ptr_used            = Module.HEAP32[(ptr+4*1)>>2];
     const curr_max            = Module.HEAP32[(ptr+4*2)>>2];
     const ptr_entity_id       = Module.HEAP32[(ptr+4*3)>>2];
-    const ptr_sprite_id       = Module.HEAP32[(ptr+4*4)>>2];
-    const ptr_sprite_origin_x = Module.HEAP32[(ptr+4*5)>>2];
-    const ptr_sprite_origin_y = Module.HEAP32[(ptr+4*6)>>2];
-    const ptr_sprite_size     = Module.HEAP32[(ptr+4*7)>>2];
-    const ptr_sprite_variant  = Module.HEAP32[(ptr+4*8)>>2];
+    const ptr_sprite_id       = Module.HEAP32[(ptr+4*(TABLE_HEADER+0))>>2];
+    const ptr_sprite_origin_x = Module.HEAP32[(ptr+4*(TABLE_HEADER+1))>>2];
+    const ptr_sprite_origin_y = Module.HEAP32[(ptr+4*(TABLE_HEADER+2))>>2];
+    const ptr_sprite_size     = Module.HEAP32[(ptr+4*(TABLE_HEADER+3))>>2];
+    const ptr_sprite_variant  = Module.HEAP32[(ptr+4*(TABLE_HEADER+4))>>2];
 
     return {
         max_count,
@@ -108,29 +164,192 @@ function get_sprite_map() {
 function get_physics_states() {
     const ptr = Module.ccall('get_physics_states', 'number');
 
-    const max_count     = Module.HEAP32[(ptr+4*0)>>2];
-    const ptr_used      = Module.HEAP32[(ptr+4*1)>>2];
-    const curr_max      = Module.HEAP32[(ptr+4*2)>>2];
-    const ptr_entity_id = Module.HEAP32[(ptr+4*3)>>2];
-    const ptr_x         = Module.HEAP32[(ptr+4*4)>>2];
-    const ptr_y         = Module.HEAP32[(ptr+4*5)>>2];
-    const ptr_x_speed   = Module.HEAP32[(ptr+4*6)>>2];
-    const ptr_y_speed   = Module.HEAP32[(ptr+4*7)>>2];
-    const ptr_angle     = Module.HEAP32[(ptr+4*8)>>2];
+    const max_count      = Module.HEAP32[(ptr+4*0)>>2];
+    const ptr_used       = Module.HEAP32[(ptr+4*1)>>2];
+    const curr_max       = Module.HEAP32[(ptr+4*2)>>2];
+    const ptr_entity_id  = Module.HEAP32[(ptr+4*3)>>2];
+    const ptr_x          = Module.HEAP32[(ptr+4*(TABLE_HEADER+0))>>2];
+    const ptr_y          = Module.HEAP32[(ptr+4*(TABLE_HEADER+1))>>2];
+    const ptr_x_speed    = Module.HEAP32[(ptr+4*(TABLE_HEADER+2))>>2];
+    const ptr_y_speed    = Module.HEAP32[(ptr+4*(TABLE_HEADER+3))>>2];
+    const ptr_angle      = Module.HEAP32[(ptr+4*(TABLE_HEADER+4))>>2];
+    const ptr_prev_x     = Module.HEAP32[(ptr+4*(TABLE_HEADER+5))>>2];
+    const ptr_prev_y     = Module.HEAP32[(ptr+4*(TABLE_HEADER+6))>>2];
+    const ptr_prev_angle = Module.HEAP32[(ptr+4*(TABLE_HEADER+7))>>2];
 
     return {
         max_count,
-        used:      new Uint8Array(Module.HEAPU8.buffer,    ptr_used,      max_count),
+        used:       new Uint8Array(Module.HEAPU8.buffer,     ptr_used,       max_count),
         curr_max,
-        entity_id: new Uint32Array(Module.HEAPF32.buffer,  ptr_entity_id, max_count),
-        x:         new Float32Array(Module.HEAPF32.buffer, ptr_x,         max_count),
-        y:         new Float32Array(Module.HEAPF32.buffer, ptr_y,         max_count),
-        x_speed:   new Float32Array(Module.HEAPF32.buffer, ptr_x_speed,   max_count),
-        y_speed:   new Float32Array(Module.HEAPF32.buffer, ptr_y_speed,   max_count),
-        angle:     new Float32Array(Module.HEAPF32.buffer, ptr_angle,     max_count),
+        entity_id:  new Uint32Array(Module.HEAPF32.buffer,   ptr_entity_id,  max_count),
+        x:          new Float32Array(Module.HEAPF32.buffer,  ptr_x,          max_count),
+        y:          new Float32Array(Module.HEAPF32.buffer,  ptr_y,          max_count),
+        x_speed:    new Float32Array(Module.HEAPF32.buffer,  ptr_x_speed,    max_count),
+        y_speed:    new Float32Array(Module.HEAPF32.buffer,  ptr_y_speed,    max_count),
+        angle:      new Float32Array(Module.HEAPF32.buffer,  ptr_angle,      max_count),
+        prev_x:     new Float32Array(Module.HEAPF32.buffer,  ptr_prev_x,     max_count),
+        prev_y:     new Float32Array(Module.HEAPF32.buffer,  ptr_prev_y,     max_count),
+        prev_angle: new Float32Array(Module.HEAPF32.buffer,  ptr_prev_angle, max_count),
+        ptr,
+    };
+}
+
+// `struct Draw_Item` is DRAW_ITEM_STRIDE 4 byte fields
+const DRAW_ITEM_STRIDE = 9;
+const DRAW_X                  = 0;
+const DRAW_Y                  = 1;
+const DRAW_ANGLE              = 2;
+const DRAW_SPRITE_ORIGIN_X    = 3;
+const DRAW_SPRITE_ORIGIN_Y    = 4;
+const DRAW_SPRITE_SIZE        = 5;
+const DRAW_HIT_FEEDBACK_ALPHA = 6;
+const DRAW_SPRITE_ID          = 7;
+const DRAW_SPRITE_VARIANT     = 8;
+// built by step() at the end of every frame
+// the views are made once and only remade when the items move,
+// which happens when a table grows or the wasm memory grows
+function get_draw_list() {
+    const ptr = Module.ccall('get_draw_list', 'number');
+
+    const max_count = Module.HEAPU32[(ptr+4*0)>>2];
+    const count     = Module.HEAPU32[(ptr+4*1)>>2];
+    const ptr_items = Module.HEAPU32[(ptr+4*2)>>2];
+
+    return {
+        max_count,
+        count,
+        items_f32: new Float32Array(Module.HEAPF32.buffer, ptr_items, max_count * DRAW_ITEM_STRIDE),
+        items_u32: new Uint32Array(Module.HEAPU32.buffer,  ptr_items, max_count * DRAW_ITEM_STRIDE),
+        ptr_items,
+        ptr,
+    };
+}
+function update_draw_list(draw_list) {
+    const ptr = draw_list.ptr;
+    draw_list.count = Module.HEAPU32[(ptr+4*1)>>2];
+    const max_count = Module.HEAPU32[(ptr+4*0)>>2];
+    const ptr_items = Module.HEAPU32[(ptr+4*2)>>2];
+    if (ptr_items !== draw_list.ptr_items ||
+        max_count !== draw_list.max_count ||
+        draw_list.items_f32.buffer !== Module.HEAPF32.buffer) {
+
+        draw_list.max_count = max_count;
+        draw_list.ptr_items = ptr_items;
+        draw_list.items_f32 = new Float32Array(Module.HEAPF32.buffer, ptr_items, max_count * DRAW_ITEM_STRIDE);
+        draw_list.items_u32 = new Uint32Array(Module.HEAPU32.buffer,  ptr_items, max_count * DRAW_ITEM_STRIDE);
+    }
+}
+
+function get_profile_data() {
+    const ptr = Module.ccall('get_profile_data', 'number');
+
+    const enabled          = Module.HEAPU32[(ptr+4*0)>>2];
+    const system_count     = Module.HEAPU32[(ptr+4*1)>>2];
+    const sample_count     = Module.HEAPU32[(ptr+4*2)>>2];
+    const next_sample      = Module.HEAPU32[(ptr+4*3)>>2];
+    const total_samples    = Module.HEAPU32[(ptr+4*4)>>2];
+    const ptr_tick_start   = Module.HEAPU32[(ptr+4*5)>>2];
+    const ptr_system_start = Module.HEAPU32[(ptr+4*6)>>2];
+    const ptr_system_time  = Module.HEAPU32[(ptr+4*7)>>2];
+
+    const system_names = [];
+    for (let i = 0; i < system_count; i += 1) {
+        system_names.push(Module.ccall('get_system_name', 'string', ['number'], [i]));
+    }
+
+    return {
+        enabled,
+        system_count,
+        sample_count,
+        next_sample,
+        total_samples,
+        system_names,
+        tick_start:   new Float64Array(Module.HEAPF64.buffer, ptr_tick_start,   sample_count),
+        system_start: new Float64Array(Module.HEAPF64.buffer, ptr_system_start, sample_count * system_count),
+        system_time:  new Float64Array(Module.HEAPF64.buffer, ptr_system_time,  sample_count * system_count),
         ptr,
     };
 }
+// the counters change every tick,
+// the arrays move when a table grows or the wasm memory grows
+function update_profile_data(profile_data) {
+    const ptr = profile_data.ptr;
+    profile_data.enabled       = Module.HEAPU32[(ptr+4*0)>>2];
+    profile_data.next_sample   = Module.HEAPU32[(ptr+4*3)>>2];
+    profile_data.total_samples = Module.HEAPU32[(ptr+4*4)>>2];
+    const ptr_tick_start = Module.HEAPU32[(ptr+4*5)>>2];
+    if (profile_data.tick_start.byteOffset !== ptr_tick_start ||
+        profile_data.tick_start.buffer !== Module.HEAPF64.buffer) {
+
+        const sample_count = profile_data.sample_count;
+        const system_count = profile_data.system_count;
+        const ptr_system_start = Module.HEAPU32[(ptr+4*6)>>2];
+        const ptr_system_time  = Module.HEAPU32[(ptr+4*7)>>2];
+        profile_data.tick_start   = new Float64Array(Module.HEAPF64.buffer, ptr_tick_start,   sample_count);
+        profile_data.system_start = new Float64Array(Module.HEAPF64.buffer, ptr_system_start, sample_count * system_count);
+        profile_data.system_time  = new Float64Array(Module.HEAPF64.buffer, ptr_system_time,  sample_count * system_count);
+    }
+}
+// rolling min / avg / p99 of every system, in milliseconds
+function get_profile_stats(profile_data, stats, scratch) {
+    const filled = Math.min(profile_data.total_samples, profile_data.sample_count);
+    for (let system = 0; system < profile_data.system_count; system += 1) {
+        let sum = 0;
+        for (let s = 0; s < filled; s += 1) {
+            const time = profile_data.system_time[s * profile_data.system_count + system];
+            scratch[s] = time;
+            sum += time;
+        }
+        const sorted = scratch.subarray(0, filled).sort();
+        const stat = stats[system];
+        stat.min = filled > 0 ? sorted[0] : 0;
+        stat.avg = filled > 0 ? sum / filled : 0;
+        stat.p99 = filled > 0 ? sorted[Math.floor((filled - 1) * 0.99)] : 0;
+    }
+}
+// Chrome trace-event JSON, open it in chrome://tracing or Perfetto
+function get_profile_trace(profile_data) {
+    const events = [];
+    const filled = Math.min(profile_data.total_samples, profile_data.sample_count);
+    // oldest sample first
+    const first = profile_data.total_samples > profile_data.sample_count ? profile_data.next_sample : 0;
+    for (let k = 0; k < filled; k += 1) {
+        const s = (first + k) % profile_data.sample_count;
+        let tick_time = 0;
+        for (let system = 0; system < profile_data.system_count; system += 1) {
+            const index = s * profile_data.system_count + system;
+            tick_time += profile_data.system_time[index];
+            events.push({
+                name: profile_data.system_names[system],
+                cat: 'system',
+                ph: 'X',
+                ts: profile_data.system_start[index] * 1000,
+                dur: profile_data.system_time[index] * 1000,
+                pid: 1,
+                tid: 1,
+            });
+        }
+        events.push({
+            name: 'tick',
+            cat: 'tick',
+            ph: 'X',
+            ts: profile_data.tick_start[s] * 1000,
+            dur: tick_time * 1000,
+            pid: 1,
+            tid: 1,
+        });
+    }
+    return JSON.stringify({ traceEvents: events, displayTimeUnit: 'ms' });
+}
+function download_text(filename, text) {
+    const blob = new Blob([text], { type: 'application/json' });
+    const url = URL.createObjectURL(blob);
+    const link = document.createElement('a');
+    link.href = url;
+    link.download = filename;
+    link.click();
+    URL.revokeObjectURL(url);
+}
 
 async function fetchImages(urls) {
     const promises = [];
@@ -160,7 +379,30 @@ function downscale(scale, imgs) {
     return canvases;
 }
 
+// offscreen canvas the size of the screen,
+// for the parts of the frame that rarely change
+function create_layer() {
+    const layer = document.createElement('canvas');
+    layer.width = canvas.width;
+    layer.height = canvas.height;
+    return layer;
+}
+
 async function main() {
+    // the background only changes when the screen is resized,
+    // the HUD only when the score or the overlay text changes
+    let background = null;
+    let background_layer = null;
+    let hud_layer = null;
+    // what the HUD layer was last drawn with
+    const hud = {
+        score: -1,
+        player_dead: 0,
+        wave_visible: false,
+        wave_start: 0,
+        wave_end: 0,
+    };
+
     window.addEventListener('resize', resize);
     resize();
 
@@ -168,9 +410,40 @@ async function main() {
         canvas.width = window.innerWidth;
         canvas.height = window.innerHeight;
         set_screen_size(window.innerWidth, window.innerHeight);
+
+        background_layer = create_layer();
+        hud_layer = create_layer();
+        // forces a redraw of the HUD
+        hud.score = -1;
+        if (background !== null) {
+            draw_background_layer();
+        }
     }
 
-    const background = downscale(1, await fetchImages(['background.png']))[0];
+    background = downscale(1, await fetchImages(['background.png']))[0];
+    draw_background_layer();
+
+    // tiled and tinted
+    function draw_background_layer() {
+        const layer_ctx = background_layer.getContext('2d');
+        layer_ctx.fillStyle = '#000';
+        layer_ctx.fillRect(0, 0, background_layer.width, background_layer.height);
+        const repeats_x = Math.ceil(background_layer.width / background.width);
+        const repeats_y = Math.ceil(background_layer.height / background.height);
+        for (let i = 0; i < repeats_x; i += 1) {
+            const x = i * background.width;
+            for (let j = 0; j < repeats_y; j += 1) {
+                const y = j * background.height;
+                layer_ctx.drawImage(background, x, y);
+            }
+        }
+        layer_ctx.globalAlpha = 0.5;
+        layer_ctx.globalCompositeOperation = 'multiply';
+        layer_ctx.fillStyle = '#210';
+        layer_ctx.fillRect(0, 0, background_layer.width, background_layer.height);
+        layer_ctx.globalCompositeOperation = 'source-over';
+        layer_ctx.globalAlpha = 1.0;
+    }
 
     const sprites = downscale(6,
                               await fetchImages(['sprites/not_found.png',
@@ -179,7 +452,30 @@ async function main() {
                                                  'sprites/bullet.png'
                                                 ]));
 
-    requestAnimationFrame(frame);
+    // p toggles the profile overlay,
+    // shift+p saves the profile as a trace
+    let draw_list = null;
+    let overlay_data = null;
+
+    let show_profile = false;
+    let profile_data = null;
+    let profile_stats = null;
+    let profile_scratch = null;
+    let profile_frame = 0;
+    window.addEventListener('keydown', (event) => {
+        if (event.key === 'p') {
+            show_profile = !show_profile;
+        }
+        if (event.key === 'P') {
+            dump_profile_trace();
+        }
+    });
+    function dump_profile_trace() {
+        update_profile_data(profile_data);
+        download_text('shooter_trace.json', get_profile_trace(profile_data));
+    }
+    window.dump_profile_trace = dump_profile_trace;
+
     function frame() {
         
         render();
@@ -188,113 +484,74 @@ async function main() {
     }
 
     function render() {
-        const hit_feedback_table = get_hit_feedback_table();
-        const weapon_states = get_weapon_states();
-        const sprite_map = get_sprite_map();
-        const physics_states = get_physics_states();
-
-        ctx.fillStyle = '#000';
-        ctx.fillRect(0, 0, canvas.width, canvas.height);
-        const repeats_x = Math.ceil(canvas.width / background.width);
-        const repeats_y = Math.ceil(canvas.height / background.height);
-        for (let i = 0; i < repeats_x; i += 1) {
-            const x = i * background.width;
-            for (let j = 0; j < repeats_y; j += 1) {
-                const y = j * background.height;
-                ctx.drawImage(background, x, y);
-            }
-        }
-        ctx.globalAlpha = 0.5;
-        ctx.globalCompositeOperation = 'multiply';
-        ctx.fillStyle = '#210';
-        ctx.fillRect(0, 0, canvas.width, canvas.height);
-        ctx.globalCompositeOperation = 'source-over';
-        ctx.globalAlpha = 1.0;
-
-        for (let i = 0; i < sprite_map.curr_max; i += 1) {
-            if (sprite_map.used[i]) {
-                const entity_id = sprite_map.entity_id[i];
-                const sprite_id = sprite_map.sprite_id[i];
-                const sprite_origin_x = sprite_map.sprite_origin_x[i];
-                const sprite_origin_y = sprite_map.sprite_origin_y[i];
-                const sprite_size = sprite_map.sprite_size[i];
-                const sprite_variant = sprite_map.sprite_variant[i];
-                const sprite = sprites[sprite_id];
-                const sprite_size_actual = sprite.height;
-                let scale = sprite_size / sprite_size_actual;
-                if (scale > 100) {
-                    scale = 1;
-                }
-                const physics_id = find_item_index(physics_states, entity_id);
-                const x = physics_states.x[physics_id];
-                const y = physics_states.y[physics_id];
-                const angle = physics_states.angle[physics_id];
-                
-                ctx.save();
-
-                ctx.translate(x, y);
-                ctx.rotate(angle);
-                ctx.translate(sprite_origin_x, sprite_origin_y);
-
-                ctx.drawImage(sprite, sprite_variant * sprite_size_actual, 0,
-                              sprite_size_actual, sprite_size_actual, 0, 0, sprite_size, sprite_size);
-
-                ctx.restore();
-                ctx.save();
-
-                const hit_feedback_id = find_item_index(hit_feedback_table, entity_id);
-                const hit_feedback_amount = hit_feedback_table.amount[hit_feedback_id];
-                
-                if (hit_feedback_id < hit_feedback_table.curr_max &&
-                    hit_feedback_amount > 0) {
-
-                    ctx.beginPath();
-                    ctx.arc(x, y, sprite_size * 0.39, 0, Math.PI*2);
-                    ctx.closePath();
-                    ctx.fillStyle = '#f00';
-                    ctx.globalAlpha = hit_feedback_amount / 100;
-                    ctx.fill();
-                }
-
-                ctx.restore();
+        update_draw_list(draw_list);
+
+        ctx.drawImage(background_layer, 0, 0);
+
+        const items_f32 = draw_list.items_f32;
+        const items_u32 = draw_list.items_u32;
+        for (let i = 0; i < draw_list.count; i += 1) {
+            const item = i * DRAW_ITEM_STRIDE;
+            const x = items_f32[item + DRAW_X];
+            const y = items_f32[item + DRAW_Y];
+            const angle = items_f32[item + DRAW_ANGLE];
+            const sprite_origin_x = items_f32[item + DRAW_SPRITE_ORIGIN_X];
+            const sprite_origin_y = items_f32[item + DRAW_SPRITE_ORIGIN_Y];
+            const sprite_size = items_f32[item + DRAW_SPRITE_SIZE];
+            const hit_feedback_alpha = items_f32[item + DRAW_HIT_FEEDBACK_ALPHA];
+            const sprite_id = items_u32[item + DRAW_SPRITE_ID];
+            const sprite_variant = items_u32[item + DRAW_SPRITE_VARIANT];
+            const sprite = sprites[sprite_id];
+            const sprite_size_actual = sprite.height;
+
+            ctx.setTransform(1, 0, 0, 1, 0, 0);
+            ctx.translate(x, y);
+            ctx.rotate(angle);
+            ctx.translate(sprite_origin_x, sprite_origin_y);
+
+            ctx.drawImage(sprite, sprite_variant * sprite_size_actual, 0,
+                          sprite_size_actual, sprite_size_actual, 0, 0, sprite_size, sprite_size);
+
+            ctx.setTransform(1, 0, 0, 1, 0, 0);
+
+            if (hit_feedback_alpha > 0) {
+                ctx.beginPath();
+                ctx.arc(x, y, sprite_size * 0.39, 0, Math.PI*2);
+                ctx.closePath();
+                ctx.fillStyle = '#f00';
+                ctx.globalAlpha = hit_feedback_alpha;
+                ctx.fill();
+                ctx.globalAlpha = 1.0;
             }
         }
         
         const score = get_score();
-        ctx.font = '48px sans-serif';
-        ctx.fillStyle = '#ddd';
-        ctx.strokeStyle = '#111';
-        ctx.textAlign = 'center';
-        ctx.lineWidth = 2;
-        ctx.fillText(score, canvas.width / 2, 50);
-        ctx.strokeText(score, canvas.width / 2, 50);
-
-        const overlay_data = get_overlay_data();
-        if (overlay_data.player_dead) {
-            ctx.font = '72px sans-serif';
-            ctx.fillStyle = '#dd0';
-            ctx.strokeStyle = '#111';
-            ctx.textAlign = 'center';
-            ctx.lineWidth = 2;
-            let text = 'YOU DIED';
-            ctx.fillText(text, canvas.width / 2, 160);
-            ctx.strokeText(text, canvas.width / 2, 160);
+        update_overlay_data(overlay_data);
+        const wave_visible = overlay_data.wave_state > 0.01;
+        if (score !== hud.score ||
+            overlay_data.player_dead !== hud.player_dead ||
+            wave_visible !== hud.wave_visible ||
+            overlay_data.wave_start !== hud.wave_start ||
+            overlay_data.wave_end !== hud.wave_end) {
+
+            hud.score = score;
+            hud.player_dead = overlay_data.player_dead;
+            hud.wave_visible = wave_visible;
+            hud.wave_start = overlay_data.wave_start;
+            hud.wave_end = overlay_data.wave_end;
+            draw_hud_layer();
         }
-        else if (overlay_data.wave_state > 0.01) {
-            ctx.font = '72px sans-serif';
-            ctx.fillStyle = '#dd0';
-            ctx.strokeStyle = '#111';
-            ctx.textAlign = 'center';
-            ctx.lineWidth = 2;
-            let text = '';
-            if (overlay_data.wave_start > 0) {
-                text = 'STARTING WAVE '+ overlay_data.wave_start;
-            }
-            if (overlay_data.wave_end > 0) {
-                text = 'FINISHED WAVE '+ overlay_data.wave_end;
+        ctx.drawImage(hud_layer, 0, 0);
+
+        if (show_profile) {
+            update_profile_data(profile_data);
+            // sorting every system every frame would show up in the profile,
+            // so the stats are refreshed a few times a second
+            if (profile_frame % 15 === 0) {
+                get_profile_stats(profile_data, profile_stats, profile_scratch);
             }
-            ctx.fillText(text, canvas.width / 2, 160);
-            ctx.strokeText(text, canvas.width / 2, 160);
+            profile_frame += 1;
+            draw_profile_overlay();
         }
 
         /*
@@ -306,7 +563,82 @@ async function main() {
         */
     }
 
-    Module.ccall('init', null, ['number', 'number'], [canvas.width, canvas.height]);
+    function draw_hud_layer() {
+        const layer_ctx = hud_layer.getContext('2d');
+        layer_ctx.clearRect(0, 0, hud_layer.width, hud_layer.height);
+
+        layer_ctx.font = '48px sans-serif';
+        layer_ctx.fillStyle = '#ddd';
+        layer_ctx.strokeStyle = '#111';
+        layer_ctx.textAlign = 'center';
+        layer_ctx.lineWidth = 2;
+        layer_ctx.fillText(hud.score, hud_layer.width / 2, 50);
+        layer_ctx.strokeText(hud.score, hud_layer.width / 2, 50);
+
+        let text = null;
+        if (hud.player_dead) {
+            text = 'YOU DIED';
+        }
+        else if (hud.wave_visible) {
+            text = '';
+            if (hud.wave_start > 0) {
+                text = 'STARTING WAVE '+ hud.wave_start;
+            }
+            if (hud.wave_end > 0) {
+                text = 'FINISHED WAVE '+ hud.wave_end;
+            }
+        }
+        if (text !== null) {
+            layer_ctx.font = '72px sans-serif';
+            layer_ctx.fillStyle = '#dd0';
+            layer_ctx.fillText(text, hud_layer.width / 2, 160);
+            layer_ctx.strokeText(text, hud_layer.width / 2, 160);
+        }
+    }
+
+    function draw_profile_overlay() {
+        const line_height = 16;
+        const width = 330;
+        const height = (profile_data.system_count + 2) * line_height;
+        const left = 10;
+        const top = canvas.height - height - 10;
+        ctx.fillStyle = 'rgba(0, 0, 0, 0.7)';
+        ctx.fillRect(left, top, width, height);
+        ctx.font = '12px monospace';
+        ctx.textAlign = 'left';
+        ctx.fillStyle = '#ddd';
+        let y = top + line_height;
+        ctx.fillText('system (ms)          min     avg     p99', left + 6, y);
+        for (let system = 0; system < profile_data.system_count; system += 1) {
+            const stat = profile_stats[system];
+            y += line_height;
+            ctx.fillText(profile_data.system_names[system].padEnd(18) +
+                         stat.min.toFixed(3).padStart(8) +
+                         stat.avg.toFixed(3).padStart(8) +
+                         stat.p99.toFixed(3).padStart(8),
+                         left + 6, y);
+        }
+    }
+
+    // ?entities=N sizes the world, 0 is the default capacity
+    const max_entity_count = Number(new URLSearchParams(window.location.search).get('entities')) || 0;
+    if (!Module.ccall('init', 'number', ['number', 'number', 'number'], [canvas.width, canvas.height, max_entity_count])) {
+        ctx.fillStyle = '#fff';
+        ctx.font = '24px sans-serif';
+        ctx.fillText('not enough memory for the world, try a smaller ?entities=N', 20, 40);
+        return;
+    }
+
+    draw_list = get_draw_list();
+    overlay_data = get_overlay_data();
+    profile_data = get_profile_data();
+    profile_scratch = new Float64Array(profile_data.sample_count);
+    profile_stats = [];
+    for (let i = 0; i < profile_data.system_count; i += 1) {
+        profile_stats.push({ min: 0, avg: 0, p99: 0 });
+    }
+
+    requestAnimationFrame(frame);
 }
 
 Module.postRun.push(main);
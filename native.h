@@ -0,0 +1,65 @@
+#pragma once
+
+// stand-ins for the emscripten API shooter.c uses,
+// so the simulation builds and runs headless on the host
+// there is no browser, so no callbacks are ever called
+// and the main loop is driven by whoever calls tick
+
+#define EMSCRIPTEN_KEEPALIVE
+
+typedef int EM_BOOL;
+
+struct EmscriptenKeyboardEvent {
+    char key[32];
+};
+struct EmscriptenMouseEvent {
+    long clientX;
+    long clientY;
+    unsigned short button;
+};
+
+typedef EM_BOOL (*em_key_callback_func)(int event_type, const struct EmscriptenKeyboardEvent* event, void* user_data);
+typedef EM_BOOL (*em_mouse_callback_func)(int event_type, const struct EmscriptenMouseEvent* event, void* user_data);
+
+static inline void emscripten_set_main_loop(void (*func)(void), int fps, int simulate_infinite_loop) {
+    (void)func;
+    (void)fps;
+    (void)simulate_infinite_loop;
+}
+static inline void emscripten_cancel_main_loop(void) {}
+
+static inline int emscripten_set_keydown_callback(const char* target, void* user_data, EM_BOOL use_capture, em_key_callback_func callback) {
+    (void)target;
+    (void)user_data;
+    (void)use_capture;
+    (void)callback;
+    return 0;
+}
+static inline int emscripten_set_keyup_callback(const char* target, void* user_data, EM_BOOL use_capture, em_key_callback_func callback) {
+    (void)target;
+    (void)user_data;
+    (void)use_capture;
+    (void)callback;
+    return 0;
+}
+static inline int emscripten_set_mousemove_callback(const char* target, void* user_data, EM_BOOL use_capture, em_mouse_callback_func callback) {
+    (void)target;
+    (void)user_data;
+    (void)use_capture;
+    (void)callback;
+    return 0;
+}
+static inline int emscripten_set_mousedown_callback(const char* target, void* user_data, EM_BOOL use_capture, em_mouse_callback_func callback) {
+    (void)target;
+    (void)user_data;
+    (void)use_capture;
+    (void)callback;
+    return 0;
+}
+static inline int emscripten_set_mouseup_callback(const char* target, void* user_data, EM_BOOL use_capture, em_mouse_callback_func callback) {
+    (void)target;
+    (void)user_data;
+    (void)use_capture;
+    (void)callback;
+    return 0;
+}
@@ -1,12 +1,31 @@
+#ifdef __EMSCRIPTEN__
 #include <emscripten/emscripten.h>
 #include <emscripten/html5.h>
+#else
+// headless native build, see bench.c
+#include "native.h"
+#endif
 #include <time.h>
 #include <math.h>
+#include <float.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#ifndef __EMSCRIPTEN__
+// snapshots are mapped, see `load_world`
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef SHOOTER_THREADS
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#endif
 
 /*  BUGS
 
@@ -92,15 +111,30 @@
 #define FIRING_SPEED 200
 #define HIT_FEEDBACK_SPEED 400
 #define MAX_FIRING_STATE 100
+#define PROXIMITY_ATTACK_SPEED 100
+#define PROXIMITY_ATTACK_PREPARE 20
 #define PLAYER_HEALTH 40
 #define ZOMBIE_HEALTH 2
 #define BULLET_DAMAGE 1
 #define BULLET_LIFETIME 5
-#define MAX_ENTITY_COUNT 2000
+// used when init isn't given a capacity
+#define DEFAULT_ENTITY_COUNT 2000
 #define AI_ENEMY_PREFERRED_DISTANCE 40
 #define AI_ENEMY_ITER_COUNT 3 // @Test if this is actually helping stabilize
-#define PHYSICS_ITER_COUNT 2
-#define PHYSICS_BALL_ITER_COUNT 2 // @Bug if these are bigger than 1, we duplicate collisions
+// how fast enemies move down the crowd density, see `step_ai_enemy`
+#define AI_ENEMY_SEPARATION_SPEED 350
+// how far `AI_Field` reaches from the player, in cells,
+// enemies further out don't keep apart
+#define AI_FIELD_RADIUS 128
+#define AI_FIELD_MAX_NODES ((2 * AI_FIELD_RADIUS + 1) * (2 * AI_FIELD_RADIUS + 1))
+// bullets are swept (see `sweep_bullets`), so they don't need substeps to hit
+#define PHYSICS_ITER_COUNT 1
+// pairs found again by a later iteration are added once, see `add_collision_item`
+#define PHYSICS_BALL_ITER_COUNT 1
+// how far a sweep looks, in grid cells per axis
+#define MAX_SWEEP_CELLS 32
+#define TICK_RATE 60
+#define MAX_CATCH_UP_TICKS 4
 
 typedef unsigned int table_id_t;
 typedef unsigned char enemy_type_t;
@@ -109,14 +143,29 @@ typedef unsigned int sprite_id_t;
 typedef float sprite_origin_t;
 typedef float sprite_size_t;
 typedef unsigned char sprite_variant_t;
+typedef unsigned int component_mask_t;
 
+typedef unsigned int uint;
+typedef unsigned char bool;
+
+// the simulation's own random numbers, so a seed replays a run
+// xorshift64*, the state is never 0
+uint64_t random_state = 1;
+EMSCRIPTEN_KEEPALIVE
+void set_random_seed(uint seed) {
+    random_state = (uint64_t)seed * 0x9E3779B97F4A7C15ull + 1;
+    if (random_state == 0) {
+        random_state = 1;
+    }
+}
+// from 0 up to, not including, 1
 EMSCRIPTEN_KEEPALIVE
 float randf() {
-    return rand() / (float)RAND_MAX;
+    random_state ^= random_state >> 12;
+    random_state ^= random_state << 25;
+    random_state ^= random_state >> 27;
+    return ((random_state * 0x2545F4914F6CDD1Dull) >> 40) / (float)(1 << 24);
 }
-
-typedef unsigned int uint;
-typedef unsigned char bool;
 enum { false, true };
 
 enum Sprites {
@@ -126,13 +175,33 @@ enum Sprites {
     SPRITE_BULLET = 3
 };
 
+// one bit per table an entity can be in,
+// so type tests don't need to join tables
+enum Components {
+    COMPONENT_NONE             = 0,
+    COMPONENT_PHYSICS_STATE    = 1 << 0,
+    COMPONENT_PHYSICS_BALL     = 1 << 1,
+    COMPONENT_PROXIMITY_ATTACK = 1 << 2,
+    COMPONENT_HIT_FEEDBACK     = 1 << 3,
+    COMPONENT_SPRITE_MAP       = 1 << 4,
+    COMPONENT_AI_ENEMY         = 1 << 5,
+    COMPONENT_BULLET           = 1 << 6,
+    COMPONENT_HEALTH           = 1 << 7,
+    // not a table, set on entities that are queued for destruction,
+    // see `struct Command_Buffer`
+    COMPONENT_DYING            = 1 << 8
+};
+
 enum Enemy_Type {
     ENEMY_PLAIN = 0
 };
 #define ENEMY_TYPE_COUNT 4
 
 struct timespec start_timestamp;
+// simulation time, advanced by every tick
 struct timespec curr_time;
+// wall clock time since start_time
+struct timespec wall_time;
 struct timespec prev_time;
 
 // stop must be bigger than start
@@ -158,6 +227,18 @@ float timespec_diff_float(const struct timespec* stop, const struct timespec* st
     timespec_diff(stop, start, &delta);
     return timespec_to_float(&delta);
 }
+void timespec_add_float(struct timespec* spec, float seconds) {
+    const long nsec = (long)(seconds * 1000000000);
+    spec->tv_sec += nsec / 1000000000;
+    spec->tv_nsec += nsec % 1000000000;
+    if (spec->tv_nsec >= 1000000000) {
+        spec->tv_sec += 1;
+        spec->tv_nsec -= 1000000000;
+    }
+}
+uint64_t timespec_to_ms(const struct timespec* spec) {
+    return (uint64_t)spec->tv_sec * 1000 + spec->tv_nsec / 1000000;
+}
 
 void step();
 bool paused = false;
@@ -174,13 +255,31 @@ void stop_time() {
     emscripten_cancel_main_loop();
 }
 float step_time() {
-    clock_gettime(CLOCK_REALTIME, &curr_time);
-    timespec_diff(&curr_time, &start_timestamp, &curr_time);
-    const float delta = timespec_diff_float(&curr_time, &prev_time);
-    prev_time = curr_time;
+    clock_gettime(CLOCK_REALTIME, &wall_time);
+    timespec_diff(&wall_time, &start_timestamp, &wall_time);
+    const float delta = timespec_diff_float(&wall_time, &prev_time);
+    prev_time = wall_time;
     return delta;
 }
 
+// in fixed timestep mode the simulation runs in ticks of 1 / TICK_RATE,
+// however long the frame took,
+// and the renderer interpolates between the last two ticks
+bool fixed_timestep = true;
+float tick_accumulator = 0;
+// how far we are between the previous and the current tick
+float tick_interpolation = 1;
+EMSCRIPTEN_KEEPALIVE
+void set_fixed_timestep(bool enabled) {
+    fixed_timestep = enabled;
+    tick_accumulator = 0;
+    tick_interpolation = 1;
+}
+EMSCRIPTEN_KEEPALIVE
+float get_tick_interpolation() {
+    return tick_interpolation;
+}
+
 int screen_width, screen_height;
 EMSCRIPTEN_KEEPALIVE
 void set_screen_size(const int width, const int height) {
@@ -188,7 +287,247 @@ void set_screen_size(const int width, const int height) {
     screen_height = height;
 }
 
+// the arrays of the world are carved from one block,
+// so memory use follows from the capacities
+// and the columns a system reads sit next to each other
+// alloc_* functions only request memory, arena_commit allocates the block
+// and hands it out zeroed, in request order, each piece on its own cache line
+// a request's size is read from its count when committing,
+// so growing a table is raising its count and laying the arena out again
+#define ARENA_ALIGNMENT 64
+#define MAX_ARENA_REQUESTS 256
+// the rows written since rollback last compared the world, see `save_rollback_chunks`
+// whoever writes a row marks it, rows of the same table or wheel share their marks
+// the first mark sets the row's bit and lists it,
+// so comparing costs the rows written, not the rows in use
+struct Row_Marks {
+    // the bits for max_count rows
+    size_t max_count;
+    uint64_t* bits;
+    table_id_t* rows;
+    size_t count;
+    // a row we had no bit for was written, every row has to be compared
+    bool all;
+};
+// after the owner's max_count changed
+// if there's no memory, rows past the old max_count mark every row
+void fit_row_marks(struct Row_Marks* marks, size_t max_count) {
+    if (max_count <= marks->max_count) {
+        return;
+    }
+    const size_t old_words = (marks->max_count + 63) / 64;
+    const size_t words = (max_count + 63) / 64;
+    uint64_t* bits = realloc(marks->bits, words * sizeof(uint64_t));
+    if (bits == NULL) {
+        return;
+    }
+    marks->bits = bits;
+    memset(&bits[old_words], 0, (words - old_words) * sizeof(uint64_t));
+    table_id_t* rows = realloc(marks->rows, max_count * sizeof(table_id_t));
+    if (rows == NULL) {
+        return;
+    }
+    marks->rows = rows;
+    marks->max_count = max_count;
+}
+void mark_row(struct Row_Marks* marks, table_id_t index) {
+    if (index >= marks->max_count) {
+        marks->all = true;
+        return;
+    }
+    const uint64_t bit = 1ull << (index & 63);
+    if ((marks->bits[index / 64] & bit) == 0) {
+        marks->bits[index / 64] |= bit;
+        marks->rows[marks->count] = index;
+        marks->count += 1;
+    }
+}
+// for marks that systems running side by side share, like entity_marks
+// the rows are listed in whatever order the systems get there,
+// which doesn't matter for comparing them
+void mark_shared_row(struct Row_Marks* marks, table_id_t index) {
+#ifdef SHOOTER_THREADS
+    if (index >= marks->max_count) {
+        __atomic_store_n(&marks->all, true, __ATOMIC_RELAXED);
+        return;
+    }
+    const uint64_t bit = 1ull << (index & 63);
+    if ((__atomic_fetch_or(&marks->bits[index / 64], bit, __ATOMIC_RELAXED) & bit) == 0) {
+        marks->rows[__atomic_fetch_add(&marks->count, 1, __ATOMIC_RELAXED)] = index;
+    }
+#else
+    mark_row(marks, index);
+#endif
+}
+void clear_row_marks(struct Row_Marks* marks) {
+    for (size_t r = 0; r < marks->count; r += 1) {
+        const table_id_t index = marks->rows[r];
+        marks->bits[index / 64] &= ~(1ull << (index & 63));
+    }
+    marks->count = 0;
+    marks->all = false;
+}
+struct Arena_Request {
+    // where to store the address of the memory
+    void** ptr;
+    size_t item_size;
+    // usually the max_count of the owning table, NULL for one item
+    const size_t* count;
+    // usually the curr_max of the owning table, items past it aren't looked at,
+    // NULL when every item is in use
+    const size_t* used_count;
+    // rebuilt every tick, so not part of the world
+    bool scratch;
+    // the rows of the request that were written,
+    // NULL when rollback compares every item in use
+    struct Row_Marks* marks;
+    // as of the last commit
+    size_t size;
+};
+struct Arena {
+    // as returned by malloc, data is aligned from it
+    char* base;
+    // when base is a mapped snapshot file, its size, otherwise 0
+    size_t mapped_size;
+    char* data;
+    size_t size;
+    size_t request_count;
+    struct Arena_Request requests[MAX_ARENA_REQUESTS];
+};
+struct Arena arena;
+size_t arena_align(size_t size) {
+    return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+// ptr is the address of the pointer that gets the memory,
+// it stays NULL until arena_commit
+void arena_request(void* ptr, size_t item_size, const size_t* count) {
+    assert(arena.request_count < MAX_ARENA_REQUESTS);
+    void** data = (void**)ptr;
+    *data = NULL;
+    arena.requests[arena.request_count].ptr = data;
+    arena.requests[arena.request_count].item_size = item_size;
+    arena.requests[arena.request_count].count = count;
+    arena.requests[arena.request_count].used_count = NULL;
+    arena.requests[arena.request_count].scratch = false;
+    arena.requests[arena.request_count].marks = NULL;
+    arena.requests[arena.request_count].size = 0;
+    arena.request_count += 1;
+}
+// for columns where only [0, *used_count) is in use,
+// so rollback compares what the world uses, not the capacity
+// with marks, it only compares the rows marked in them
+void arena_request_rows(void* ptr, size_t item_size, const size_t* count, const size_t* used_count,
+                        struct Row_Marks* marks) {
+    arena_request(ptr, item_size, count);
+    arena.requests[arena.request_count - 1].used_count = used_count;
+    arena.requests[arena.request_count - 1].marks = marks;
+}
+// for the systems' scratch space, which rollback leaves alone
+void arena_request_scratch(void* ptr, size_t item_size, const size_t* count) {
+    arena_request(ptr, item_size, count);
+    arena.requests[arena.request_count - 1].scratch = true;
+}
+size_t get_request_size(const struct Arena_Request* request) {
+    if (request->count == NULL) {
+        return request->item_size;
+    }
+    return request->item_size * *request->count;
+}
+// leaves the arena as it was if there's no memory
+bool arena_commit() {
+    size_t size = 0;
+    for (size_t r = 0; r < arena.request_count; r += 1) {
+        size += arena_align(get_request_size(&arena.requests[r]));
+    }
+    char* base = malloc(size + ARENA_ALIGNMENT - 1);
+    if (base == NULL) {
+        return false;
+    }
+    arena.base = base;
+    arena.mapped_size = 0;
+    arena.data = (char*)(((uintptr_t)base + ARENA_ALIGNMENT - 1) & ~(uintptr_t)(ARENA_ALIGNMENT - 1));
+    arena.size = size;
+    memset(arena.data, 0, size);
+
+    size_t offset = 0;
+    for (size_t r = 0; r < arena.request_count; r += 1) {
+        struct Arena_Request* request = &arena.requests[r];
+        request->size = get_request_size(request);
+        *request->ptr = arena.data + offset;
+        offset += arena_align(request->size);
+    }
+    return true;
+}
+void arena_release(char* base, size_t mapped_size) {
+#ifndef __EMSCRIPTEN__
+    if (mapped_size > 0) {
+        munmap(base, mapped_size);
+        return;
+    }
+#endif
+    free(base);
+}
+// call after raising a count
+// every array moves, keeping its items, the new items are zeroed
+// so nobody may hold on to a column pointer across an add
+bool arena_regrow() {
+    static void* old_data[MAX_ARENA_REQUESTS];
+    static size_t old_size[MAX_ARENA_REQUESTS];
+    char* old_base = arena.base;
+    const size_t old_mapped_size = arena.mapped_size;
+    for (size_t r = 0; r < arena.request_count; r += 1) {
+        old_data[r] = *arena.requests[r].ptr;
+        old_size[r] = arena.requests[r].size;
+    }
+    if (!arena_commit()) {
+        return false;
+    }
+    for (size_t r = 0; r < arena.request_count; r += 1) {
+        const struct Arena_Request* request = &arena.requests[r];
+        const size_t size = old_size[r] < request->size ? old_size[r] : request->size;
+        memcpy(*request->ptr, old_data[r], size);
+    }
+    arena_release(old_base, old_mapped_size);
+    return true;
+}
+EMSCRIPTEN_KEEPALIVE
+size_t get_arena_size() {
+    return arena.size;
+}
+
+// entity ids are handles,
+// the low ENTITY_SLOT_BITS are the entity's slot in the entity table
+// and the rest is how often the slot has been reused,
+// so an id kept after its entity is destroyed never matches the next entity in the slot
+// and row indices cached for an id can be checked with a compare
+// 18 bits of slot leave 14 for the generation,
+// and a slot whose generation would wrap is retired instead of reused,
+// so an old id can't come back to life however hot its slot is
+#define ENTITY_SLOT_BITS 18
+#define ENTITY_SLOT_MASK ((1u << ENTITY_SLOT_BITS) - 1)
+#define ENTITY_GENERATION_MASK ((table_id_t)-1 >> ENTITY_SLOT_BITS)
+// the all ones slot is never used, so no handle is NO_ENTITY
+#define MAX_ENTITY_SLOTS ENTITY_SLOT_MASK
+#define NO_ENTITY ((table_id_t)-1)
+table_id_t get_entity_slot(table_id_t entity_id) {
+    return entity_id & ENTITY_SLOT_MASK;
+}
+table_id_t get_entity_generation(table_id_t entity_id) {
+    return entity_id >> ENTITY_SLOT_BITS;
+}
+
+// capacity of the entity table,
+// every table's entity_index has this many items
+// grows with the entity table
+size_t max_entity_count;
+
 // table abstraction
+struct Table_Column {
+    // address of the column pointer in the concrete table
+    void** data;
+    size_t item_size;
+};
+#define MAX_TABLE_COLUMNS 8
 // all concrete tables much have these elements first
 // so we can use generic functions on them
 struct Table {
@@ -201,16 +540,182 @@ struct Table {
     size_t curr_max;
     // global id that's used to join tables
     table_id_t* entity_id;
+    // sparse array from entity slot to item index,
+    // so joining is a lookup instead of a search
+    table_id_t* entity_index;
+    // free items form a linked list through their entity_id,
+    // so adding an item doesn't have to search for one
+    table_id_t first_free;
+    // packed tables keep their items in [0, curr_max),
+    // removing an item moves the last item into its place,
+    // so loops don't need to check used
+    bool packed;
+    // the rest of the concrete table's columns,
+    // so generic functions can move items around
+    size_t column_count;
+    struct Table_Column* columns;
+    // the bit that's set in the entity's component mask
+    // while it has an item in this table
+    component_mask_t component;
+    // the rows that changed, see `export_table_delta`
+    struct Table_Changes* changes;
+};
+// ends the free list
+#define NO_FREE_ITEM ((table_id_t)-1)
+
+// readers that keep a copy of the tables, like a renderer or a tool,
+// only have to read the rows that changed, see `export_table_delta`
+// whoever writes a row marks it, add_table_item, remove_table_item and the systems,
+// the first mark of a frame sets the row's bit and puts it on the frame's list,
+// so a frame costs the rows it changed, not the capacity
+// at the end of the frame, the marked rows become the entity ids in them,
+// which stay put when packed tables move rows around,
+// and removed entities are listed when they're removed
+// the row indices other tables cache, like ai_enemy->physics_id, aren't marked
+#define CHANGE_FRAME_COUNT 64
+struct Change_Frame {
+    table_id_t* entity_id;
+    size_t count;
+    size_t max_count;
 };
-void alloc_table(void* table_ptr, size_t max_count) {
+struct Table_Changes {
+    // the bits for max_count rows
+    size_t max_count;
+    uint64_t* dirty;
+    // the rows marked this frame
+    table_id_t* rows;
+    size_t row_count;
+    // the entities changed in frame f are at f % CHANGE_FRAME_COUNT
+    struct Change_Frame frames[CHANGE_FRAME_COUNT];
+    // the same rows, for rollback, which looks after every tick, not every frame
+    struct Row_Marks rollback;
+};
+// frames ended since init, the changes being marked are for this one
+size_t change_frame = 0;
+// the last frame any row may have changed without being marked,
+// like when a world is loaded, readers from before it get every row
+size_t all_changed_frame = 0;
+void mark_all_changed() {
+    all_changed_frame = change_frame;
+}
+// after the table's max_count changed
+// if there's no memory, rows past the old max_count change everything
+void fit_table_changes(void* table_ptr) {
     struct Table* table = (struct Table*)table_ptr;
-    table->max_count = max_count;
-    table->used = malloc(max_count * sizeof(bool));
-    for (table_id_t i = 0; i < max_count; i += 1) {
-        table->used[i] = false;
+    struct Table_Changes* changes = table->changes;
+    if (table->max_count <= changes->max_count) {
+        return;
+    }
+    fit_row_marks(&changes->rollback, table->max_count);
+    const size_t old_words = (changes->max_count + 63) / 64;
+    const size_t words = (table->max_count + 63) / 64;
+    uint64_t* dirty = realloc(changes->dirty, words * sizeof(uint64_t));
+    if (dirty == NULL) {
+        return;
+    }
+    changes->dirty = dirty;
+    memset(&dirty[old_words], 0, (words - old_words) * sizeof(uint64_t));
+    table_id_t* rows = realloc(changes->rows, table->max_count * sizeof(table_id_t));
+    if (rows == NULL) {
+        return;
+    }
+    changes->rows = rows;
+    changes->max_count = table->max_count;
+}
+// the entity's row in the table changed this frame, or the entity left it
+void log_changed_entity(struct Table_Changes* changes, table_id_t entity_id) {
+    struct Change_Frame* frame = &changes->frames[change_frame % CHANGE_FRAME_COUNT];
+    if (frame->count == frame->max_count) {
+        const size_t max_count = frame->max_count == 0 ? 64 : frame->max_count * 2;
+        table_id_t* entity_id_list = realloc(frame->entity_id, max_count * sizeof(table_id_t));
+        if (entity_id_list == NULL) {
+            mark_all_changed();
+            return;
+        }
+        frame->entity_id = entity_id_list;
+        frame->max_count = max_count;
+    }
+    frame->entity_id[frame->count] = entity_id;
+    frame->count += 1;
+}
+// call after writing any column of the row
+void mark_item_changed(void* table_ptr, table_id_t index) {
+    struct Table_Changes* changes = ((struct Table*)table_ptr)->changes;
+    mark_row(&changes->rollback, index);
+    if (index >= changes->max_count) {
+        mark_all_changed();
+        return;
+    }
+    const uint64_t bit = 1ull << (index & 63);
+    if ((changes->dirty[index / 64] & bit) == 0) {
+        changes->dirty[index / 64] |= bit;
+        changes->rows[changes->row_count] = index;
+        changes->row_count += 1;
+    }
+}
+// the marked rows become the frame's entity ids
+void end_table_changes(void* table_ptr) {
+    struct Table* table = (struct Table*)table_ptr;
+    struct Table_Changes* changes = table->changes;
+    for (size_t r = 0; r < changes->row_count; r += 1) {
+        const table_id_t index = changes->rows[r];
+        changes->dirty[index / 64] &= ~(1ull << (index & 63));
+        // the row was emptied after it was marked
+        if (index < table->curr_max && table->used[index]) {
+            log_changed_entity(changes, table->entity_id[index]);
+        }
     }
+    changes->row_count = 0;
+    changes->frames[(change_frame + 1) % CHANGE_FRAME_COUNT].count = 0;
+}
+// &entity_table->curr_max, the entity slots in use
+const size_t* get_used_entity_slots();
+// the entity slots written, which every table's entity_index is indexed by
+struct Row_Marks entity_marks;
+// the arrays come from the arena, zeroed,
+// so every item starts unused
+void alloc_table(void* table_ptr, size_t max_count, bool packed, component_mask_t component) {
+    struct Table* table = (struct Table*)table_ptr;
+    table->max_count = max_count;
+    table->changes = calloc(1, sizeof(struct Table_Changes));
+    struct Row_Marks* marks = &table->changes->rollback;
+    arena_request_rows(&table->used, sizeof(bool), &table->max_count, &table->curr_max, marks);
     table->curr_max = 0;
-    table->entity_id = malloc(max_count * sizeof(table_id_t));
+    arena_request_rows(&table->entity_id, sizeof(table_id_t), &table->max_count, &table->curr_max, marks);
+    // indexed by entity slot, not by item index
+    arena_request_rows(&table->entity_index, sizeof(table_id_t), &max_entity_count, get_used_entity_slots(),
+                       &entity_marks);
+    table->first_free = NO_FREE_ITEM;
+    table->packed = packed;
+    table->column_count = 0;
+    table->columns = malloc(MAX_TABLE_COLUMNS * sizeof(struct Table_Column));
+    table->component = component;
+    fit_table_changes(table);
+}
+// column_ptr is the address of the column in the concrete table
+void alloc_table_column(void* table_ptr, void* column_ptr, size_t item_size) {
+    struct Table* table = (struct Table*)table_ptr;
+    assert(table->column_count < MAX_TABLE_COLUMNS);
+    void** data = (void**)column_ptr;
+    arena_request_rows(data, item_size, &table->max_count, &table->curr_max, &table->changes->rollback);
+    table->columns[table->column_count].data = data;
+    table->columns[table->column_count].item_size = item_size;
+    table->column_count += 1;
+}
+void set_entity_components(table_id_t entity_id, component_mask_t components);
+void clear_entity_components(table_id_t entity_id, component_mask_t components);
+
+// a cheap check for a row index kept from an earlier join,
+// true while the row still holds the entity
+// rows move when packed tables remove items, and handles are never reused,
+// so a stale index fails the compare
+bool is_item_index_valid(const void* table_ptr, table_id_t index, table_id_t entity_id) {
+    const struct Table* table = (const struct Table*)table_ptr;
+    // free items link the free list through entity_id,
+    // packed tables have none below curr_max
+    return index < table->curr_max &&
+           (table->packed || table->used[index]) &&
+           table->entity_id[index] == entity_id;
 }
 // used for joining tables
 // based on their shared index to the entity table
@@ -218,60 +723,136 @@ void alloc_table(void* table_ptr, size_t max_count) {
 EMSCRIPTEN_KEEPALIVE
 table_id_t find_item_index(void* table_ptr, table_id_t entity_id) {
     const struct Table* table = (struct Table*)table_ptr;
-    table_id_t index = 0;
 
-    // @Audit
-    // linear search
-    while (index < table->curr_max) {
-        if (table->entity_id[index] == entity_id &&
-            table->used[index]) {
-            break;
+    const table_id_t slot = get_entity_slot(entity_id);
+    if (slot < max_entity_count) {
+        const table_id_t index = table->entity_index[slot];
+        // the sparse array is never cleared,
+        // so we only trust an index that points back at this entity
+        if (is_item_index_valid(table, index, entity_id)) {
+            return index;
         }
-        index += 1;
     }
 
-    return index;
+    return table->curr_max;
+}
+// for tables with one item per entity
+// cached is a row index kept in row cache_row of the caller's table,
+// it's refreshed if it went stale
+// readers don't need the refresh, but rollback keeps it, so the row is marked for rollback only
+table_id_t find_cached_item_index(void* table_ptr, table_id_t entity_id,
+                                  void* cache_table_ptr, table_id_t cache_row, table_id_t* cached) {
+    if (!is_item_index_valid(table_ptr, *cached, entity_id)) {
+        *cached = find_item_index(table_ptr, entity_id);
+        mark_row(&((struct Table*)cache_table_ptr)->changes->rollback, cache_row);
+    }
+    return *cached;
 }
-table_id_t find_first_unused_item(void* table_ptr) {
+// doubles the capacity, which moves every array of the world
+// returns false if there's no memory
+bool grow_table(void* table_ptr) {
     struct Table* table = (struct Table*)table_ptr;
-    table_id_t index = 0;
-    
-    // @Audit
-    // should this be < instead of <=
-    while (index <= table->curr_max) {
-        if (table->used[index]) {
-            index += 1;
-            continue;
-        }
-        else {
-            break;
-        }
+    const size_t max_count = table->max_count;
+    table->max_count = max_count * 2;
+    if (!arena_regrow()) {
+        table->max_count = max_count;
+        return false;
     }
-
-    return index;
+    fit_table_changes(table);
+    return true;
 }
-// returns table->max_count if table is full
+// a full table grows
+// returns table->max_count if there's no memory to grow
 table_id_t add_table_item(void* table_ptr, table_id_t entity_id) {
     struct Table* table = (struct Table*)table_ptr;
-    table_id_t index = find_first_unused_item(table);
-    if (index == table->curr_max) {
+    // an entity can have multiple items,
+    // joins find the first one, like the linear search used to
+    const bool has_item = find_item_index(table, entity_id) < table->curr_max;
+    table_id_t index;
+    if (table->first_free != NO_FREE_ITEM) {
+        index = table->first_free;
+        table->first_free = table->entity_id[index];
+    }
+    else if (table->curr_max < table->max_count || grow_table(table)) {
+        index = table->curr_max;
         table->curr_max += 1;
     }
-    if (index < table->max_count) {
-        table->entity_id[index] = entity_id;
-        table->used[index] = true;
+    else {
+        return table->max_count;
+    }
+    table->entity_id[index] = entity_id;
+    table->used[index] = true;
+    const table_id_t slot = get_entity_slot(entity_id);
+    if (!has_item && slot < max_entity_count) {
+        table->entity_index[slot] = index;
+        mark_shared_row(&entity_marks, slot);
     }
+    set_entity_components(entity_id, table->component);
+    mark_item_changed(table, index);
     return index;
 }
 void remove_table_item(void* table_ptr, table_id_t entity_id) {
     struct Table* table = (struct Table*)table_ptr;
     const table_id_t index = find_item_index(table_ptr, entity_id);
+    if (index == table->curr_max) {
+        return;
+    }
+    clear_entity_components(entity_id, table->component);
+    log_changed_entity(table->changes, entity_id);
+    if (table->packed) {
+        const table_id_t last = table->curr_max - 1;
+        mark_row(&table->changes->rollback, last);
+        if (index != last) {
+            // the last row moves into the removed one
+            mark_item_changed(table, index);
+            const table_id_t last_entity_id = table->entity_id[last];
+            table->entity_id[index] = last_entity_id;
+            for (size_t c = 0; c < table->column_count; c += 1) {
+                const size_t item_size = table->columns[c].item_size;
+                char* data = *table->columns[c].data;
+                memcpy(data + index * item_size, data + last * item_size, item_size);
+            }
+            // entities with multiple items are joined on their first one,
+            // which doesn't have to be the one we moved
+            const table_id_t last_slot = get_entity_slot(last_entity_id);
+            if (last_slot < max_entity_count &&
+                table->entity_index[last_slot] == last) {
+
+                table->entity_index[last_slot] = index;
+                mark_shared_row(&entity_marks, last_slot);
+            }
+        }
+        table->used[last] = false;
+        table->curr_max -= 1;
+        return;
+    }
+    mark_row(&table->changes->rollback, index);
     table->used[index] = false;
-    // if we remove the last item
-    // update the curr_max
-    while (table->used[table->curr_max - 1] == false && table->curr_max > 0) {
+    // if we remove the last item, we can iterate one less,
+    // otherwise the item is reused by the next add
+    // free items below curr_max stay in the free list,
+    // so curr_max never has to walk backwards
+    if (index + 1 == table->curr_max) {
         table->curr_max -= 1;
     }
+    else {
+        table->entity_id[index] = table->first_free;
+        table->first_free = index;
+    }
+}
+// for tables that are rebuilt every frame
+void clear_table(void* table_ptr) {
+    struct Table* table = (struct Table*)table_ptr;
+    for (table_id_t i = 0; i < table->curr_max; i += 1) {
+        if (table->used[i]) {
+            clear_entity_components(table->entity_id[i], table->component);
+            log_changed_entity(table->changes, table->entity_id[i]);
+        }
+        mark_row(&table->changes->rollback, i);
+        table->used[i] = false;
+    }
+    table->curr_max = 0;
+    table->first_free = NO_FREE_ITEM;
 }
 
 // @Audit
@@ -282,36 +863,372 @@ struct Entity_Table {
     size_t max_count;
     bool* used;
     size_t curr_max;
+    // same free list as the table abstraction,
+    // but entities have no entity_id to link through
+    table_id_t* next_free;
+    table_id_t first_free;
+    // which tables the entity is in, see `enum Components`
+    component_mask_t* components;
+    // bumped when the slot's entity is removed,
+    // the generation part of the slot's next handle,
+    // slots that reach ENTITY_GENERATION_MASK are never reused
+    table_id_t* generation;
 };
 struct Entity_Table* entity_table;
+const size_t* get_used_entity_slots() {
+    return &entity_table->curr_max;
+}
 void alloc_entity_table(size_t max_count) {
     struct Entity_Table* table = malloc(sizeof(struct Entity_Table));
     entity_table = table;
     table->max_count = max_count;
-    table->used = malloc(max_count * sizeof(bool));
-    for (table_id_t i = 0; i < max_count; i += 1) {
-        table->used[i] = false;
-    }
+    fit_row_marks(&entity_marks, max_count);
+    arena_request_rows(&table->used, sizeof(bool), &table->max_count, &table->curr_max, &entity_marks);
     table->curr_max = 0;
+    arena_request_rows(&table->next_free, sizeof(table_id_t), &table->max_count, &table->curr_max, &entity_marks);
+    table->first_free = NO_FREE_ITEM;
+    arena_request_rows(&table->components, sizeof(component_mask_t), &table->max_count, &table->curr_max,
+                       &entity_marks);
+    arena_request_rows(&table->generation, sizeof(table_id_t), &table->max_count, &table->curr_max,
+                       &entity_marks);
+}
+// every table's entity_index grows with it
+// up to MAX_ENTITY_SLOTS, handles have no room for more
+bool grow_entity_table() {
+    const size_t max_count = entity_table->max_count;
+    if (max_count >= MAX_ENTITY_SLOTS) {
+        return false;
+    }
+    entity_table->max_count = max_count * 2;
+    if (entity_table->max_count > MAX_ENTITY_SLOTS) {
+        entity_table->max_count = MAX_ENTITY_SLOTS;
+    }
+    max_entity_count = entity_table->max_count;
+    if (!arena_regrow()) {
+        entity_table->max_count = max_count;
+        max_entity_count = max_count;
+        return false;
+    }
+    fit_row_marks(&entity_marks, max_entity_count);
+    return true;
 }
+// a full entity table grows
+// returns NO_ENTITY if there's no memory to grow
 table_id_t create_entity() {
-    const table_id_t entity_id = find_first_unused_item(entity_table);
-    
-    if (entity_id == entity_table->curr_max) {
-        entity_table->curr_max += 1;
+    struct Entity_Table* table = entity_table;
+    table_id_t slot;
+    if (table->first_free != NO_FREE_ITEM) {
+        slot = table->first_free;
+        table->first_free = table->next_free[slot];
     }
-    if (entity_id < entity_table->max_count) {
-        entity_table->used[entity_id] = true;
+    else if (table->curr_max < table->max_count || grow_entity_table()) {
+        slot = table->curr_max;
+        table->curr_max += 1;
     }
-    return entity_id;
+    else {
+        return NO_ENTITY;
+    }
+    table->used[slot] = true;
+    table->components[slot] = COMPONENT_NONE;
+    mark_shared_row(&entity_marks, slot);
+    return slot | (table->generation[slot] << ENTITY_SLOT_BITS);
+}
+// false for handles of removed entities
+bool is_entity_alive(table_id_t entity_id) {
+    const table_id_t slot = get_entity_slot(entity_id);
+    return slot < entity_table->curr_max &&
+           entity_table->used[slot] &&
+           entity_table->generation[slot] == get_entity_generation(entity_id);
 }
 // the user of a table should remove the entity themself
 void remove_entity(table_id_t entity_id) {
-    struct Table* table = (struct Table*)entity_table;
-    table->used[entity_id] = false;
-    while (table->used[table->curr_max - 1] == false && table->curr_max > 0) {
+    struct Entity_Table* table = entity_table;
+    if (!is_entity_alive(entity_id)) {
+        return;
+    }
+    const table_id_t slot = get_entity_slot(entity_id);
+    mark_shared_row(&entity_marks, slot);
+    table->used[slot] = false;
+    table->components[slot] = COMPONENT_NONE;
+    if (table->generation[slot] == ENTITY_GENERATION_MASK) {
+        // retired, stays unused and off the free list
+        return;
+    }
+    table->generation[slot] += 1;
+    if (slot + 1 == table->curr_max) {
         table->curr_max -= 1;
     }
+    else {
+        table->next_free[slot] = table->first_free;
+        table->first_free = slot;
+    }
+}
+// systems running side by side change the bits of different tables in the same mask,
+// so with SHOOTER_THREADS the masks are changed and read atomically
+void set_entity_components(table_id_t entity_id, component_mask_t components) {
+    if (is_entity_alive(entity_id)) {
+        const table_id_t slot = get_entity_slot(entity_id);
+#ifdef SHOOTER_THREADS
+        __atomic_fetch_or(&entity_table->components[slot], components, __ATOMIC_RELAXED);
+#else
+        entity_table->components[slot] |= components;
+#endif
+        mark_shared_row(&entity_marks, slot);
+    }
+}
+void clear_entity_components(table_id_t entity_id, component_mask_t components) {
+    if (is_entity_alive(entity_id)) {
+        const table_id_t slot = get_entity_slot(entity_id);
+#ifdef SHOOTER_THREADS
+        __atomic_fetch_and(&entity_table->components[slot], ~components, __ATOMIC_RELAXED);
+#else
+        entity_table->components[slot] &= ~components;
+#endif
+        mark_shared_row(&entity_marks, slot);
+    }
+}
+// true if the entity is in all the tables of the mask
+bool has_components(table_id_t entity_id, component_mask_t components) {
+    if (!is_entity_alive(entity_id)) {
+        return false;
+    }
+#ifdef SHOOTER_THREADS
+    const component_mask_t mask = __atomic_load_n(&entity_table->components[get_entity_slot(entity_id)],
+                                                  __ATOMIC_RELAXED);
+#else
+    const component_mask_t mask = entity_table->components[get_entity_slot(entity_id)];
+#endif
+    return (mask & components) == components;
+}
+
+EMSCRIPTEN_KEEPALIVE
+struct Entity_Table* get_entity_table() {
+    return entity_table;
+}
+
+// lifetimes and cooldowns register when they run out,
+// so a tick only touches the timers that fire,
+// not every row of the tables that have them
+// a hierarchical timer wheel in milliseconds of simulation time,
+// level l has TIMER_WHEEL_SLOTS slots of TIMER_WHEEL_SLOTS^l ms,
+// and a timer moves down a level every time its slot comes up
+// timers aren't cancelled, the timer's owner checks if it still applies
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_LEVELS 4
+// about 4.6 hours, timers further out fire then
+#define MAX_TIMER_DELAY (((uint64_t)1 << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) - 1)
+#define NO_TIMER ((table_id_t)-1)
+enum Timer_Type {
+    TIMER_BULLET_LIFETIME,
+    TIMER_PROXIMITY_PREPARE,
+    TIMER_PROXIMITY_READY,
+    TIMER_HIT_FEEDBACK,
+    TIMER_WEAPON_READY
+};
+struct Timer_Wheel {
+    size_t max_count;
+    size_t curr_max;
+    table_id_t first_free;
+    // the wheel has fired everything up to and including now
+    uint64_t now;
+    // heads of the slot lists, level by level
+    table_id_t* slot_first;
+    // per timer, slot lists and the free list link through next
+    table_id_t* next;
+    uint64_t* expire_at;
+    // an entity, or a weapon for TIMER_WEAPON_READY
+    table_id_t* id;
+    unsigned char* type;
+    // the timers written, slot_first is small enough to compare whole
+    struct Row_Marks marks;
+    // scratch, the timers the last advance fired
+    size_t fired_count;
+    unsigned char* fired_type;
+    table_id_t* fired_id;
+    uint64_t* fired_expire_at;
+};
+struct Timer_Wheel* timer_wheel;
+void alloc_timer_wheel(size_t max_count) {
+    timer_wheel = calloc(1, sizeof(struct Timer_Wheel));
+    timer_wheel->max_count = max_count;
+    struct Row_Marks* marks = &timer_wheel->marks;
+    fit_row_marks(marks, max_count);
+    timer_wheel->curr_max = 0;
+    timer_wheel->first_free = NO_TIMER;
+    timer_wheel->now = 0;
+    arena_request(&timer_wheel->slot_first, TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS * sizeof(table_id_t), NULL);
+    arena_request_rows(&timer_wheel->next, sizeof(table_id_t), &timer_wheel->max_count, &timer_wheel->curr_max, marks);
+    arena_request_rows(&timer_wheel->expire_at, sizeof(uint64_t), &timer_wheel->max_count, &timer_wheel->curr_max, marks);
+    arena_request_rows(&timer_wheel->id, sizeof(table_id_t), &timer_wheel->max_count, &timer_wheel->curr_max, marks);
+    arena_request_rows(&timer_wheel->type, sizeof(unsigned char), &timer_wheel->max_count, &timer_wheel->curr_max, marks);
+    arena_request_scratch(&timer_wheel->fired_type, sizeof(unsigned char), &timer_wheel->max_count);
+    arena_request_scratch(&timer_wheel->fired_id, sizeof(table_id_t), &timer_wheel->max_count);
+    arena_request_scratch(&timer_wheel->fired_expire_at, sizeof(uint64_t), &timer_wheel->max_count);
+}
+// after arena_commit, and to drop every timer
+void reset_timer_wheel() {
+    for (size_t s = 0; s < TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS; s += 1) {
+        timer_wheel->slot_first[s] = NO_TIMER;
+    }
+    timer_wheel->curr_max = 0;
+    timer_wheel->first_free = NO_TIMER;
+    timer_wheel->fired_count = 0;
+}
+uint64_t get_time_ms() {
+    return timespec_to_ms(&curr_time);
+}
+// rounded up, so the timer never fires early
+uint64_t get_time_ms_after(float seconds) {
+    return get_time_ms() + (uint64_t)ceilf(seconds * 1000);
+}
+// earliest is the first ms whose slot hasn't been fired yet
+void place_timer(table_id_t timer, uint64_t earliest) {
+    struct Timer_Wheel* wheel = timer_wheel;
+    uint64_t expire_at = wheel->expire_at[timer];
+    if (expire_at < earliest) {
+        expire_at = earliest;
+    }
+    const uint64_t delay = expire_at - wheel->now;
+    size_t level = 0;
+    while (level + 1 < TIMER_WHEEL_LEVELS &&
+           delay >= (uint64_t)1 << (TIMER_WHEEL_BITS * (level + 1))) {
+        level += 1;
+    }
+    const size_t slot = level * TIMER_WHEEL_SLOTS +
+                        ((expire_at >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1));
+    wheel->next[timer] = wheel->slot_first[slot];
+    wheel->slot_first[slot] = timer;
+    mark_row(&wheel->marks, timer);
+}
+// doubles the capacity, like grow_table
+bool grow_timer_wheel() {
+    const size_t max_count = timer_wheel->max_count;
+    timer_wheel->max_count = max_count * 2;
+    if (!arena_regrow()) {
+        timer_wheel->max_count = max_count;
+        return false;
+    }
+    fit_row_marks(&timer_wheel->marks, timer_wheel->max_count);
+    return true;
+}
+// a full wheel grows
+// returns false if there's no memory to grow
+bool place_new_timer(enum Timer_Type type, table_id_t id, uint64_t expire_at) {
+    struct Timer_Wheel* wheel = timer_wheel;
+    if (expire_at > wheel->now + MAX_TIMER_DELAY) {
+        expire_at = wheel->now + MAX_TIMER_DELAY;
+    }
+    table_id_t timer;
+    if (wheel->first_free != NO_TIMER) {
+        timer = wheel->first_free;
+        wheel->first_free = wheel->next[timer];
+    }
+    else if (wheel->curr_max < wheel->max_count || grow_timer_wheel()) {
+        timer = wheel->curr_max;
+        wheel->curr_max += 1;
+    }
+    else {
+        return false;
+    }
+    wheel->expire_at[timer] = expire_at;
+    wheel->id[timer] = id;
+    wheel->type[timer] = type;
+    // a timer that's already due fires on the next ms
+    place_timer(timer, wheel->now + 1);
+    return true;
+}
+// while a tick's systems run, each one queues the timers it adds,
+// and they're placed after the systems, in the order of `enum Systems`,
+// so systems that add timers can run side by side,
+// and the wheel comes out the same however they were scheduled
+struct Queued_Timer {
+    uint64_t expire_at;
+    table_id_t id;
+    unsigned char type;
+};
+struct Timer_Queue {
+    struct Queued_Timer* items;
+    size_t count;
+    size_t max_count;
+};
+// the queue of the system running on this thread, NULL outside of the systems
+_Thread_local struct Timer_Queue* timer_queue = NULL;
+// returns false if there's no memory for the timer
+bool add_timer(enum Timer_Type type, table_id_t id, uint64_t expire_at) {
+    struct Timer_Queue* queue = timer_queue;
+    if (queue == NULL) {
+        return place_new_timer(type, id, expire_at);
+    }
+    // the queue is the system's own, so it grows with realloc, not the arena
+    if (queue->count == queue->max_count) {
+        const size_t max_count = queue->max_count == 0 ? 64 : queue->max_count * 2;
+        struct Queued_Timer* items = realloc(queue->items, max_count * sizeof(struct Queued_Timer));
+        if (items == NULL) {
+            return false;
+        }
+        queue->items = items;
+        queue->max_count = max_count;
+    }
+    queue->items[queue->count].expire_at = expire_at;
+    queue->items[queue->count].id = id;
+    queue->items[queue->count].type = type;
+    queue->count += 1;
+    return true;
+}
+// timers that don't fit are dropped, like add_timer would
+void place_queued_timers(struct Timer_Queue* queue) {
+    for (size_t i = 0; i < queue->count; i += 1) {
+        const struct Queued_Timer* item = &queue->items[i];
+        place_new_timer(item->type, item->id, item->expire_at);
+    }
+    queue->count = 0;
+}
+// runs the wheel up to time, a ms at a time,
+// and lists the timers that fired, in firing order, for the systems that handle them
+void advance_timer_wheel(uint64_t time) {
+    struct Timer_Wheel* wheel = timer_wheel;
+    wheel->fired_count = 0;
+    while (wheel->now < time) {
+        wheel->now += 1;
+        // when a level wraps, the next level's slot moves down,
+        // top level first, so its timers can cascade all the way
+        size_t wrapped = 0;
+        while (wrapped + 1 < TIMER_WHEEL_LEVELS &&
+               ((wheel->now >> (TIMER_WHEEL_BITS * wrapped)) & (TIMER_WHEEL_SLOTS - 1)) == 0) {
+            wrapped += 1;
+        }
+        for (size_t level = wrapped; level > 0; level -= 1) {
+            const size_t slot = level * TIMER_WHEEL_SLOTS +
+                                ((wheel->now >> (TIMER_WHEEL_BITS * level)) & (TIMER_WHEEL_SLOTS - 1));
+            table_id_t timer = wheel->slot_first[slot];
+            wheel->slot_first[slot] = NO_TIMER;
+            while (timer != NO_TIMER) {
+                const table_id_t next = wheel->next[timer];
+                // due this ms, before the level 0 slot is fired
+                place_timer(timer, wheel->now);
+                timer = next;
+            }
+        }
+
+        const size_t slot = wheel->now & (TIMER_WHEEL_SLOTS - 1);
+        table_id_t timer = wheel->slot_first[slot];
+        wheel->slot_first[slot] = NO_TIMER;
+        while (timer != NO_TIMER) {
+            const table_id_t next = wheel->next[timer];
+            // nothing is placed while the wheel runs,
+            // so no more timers fire than there were
+            const size_t f = wheel->fired_count;
+            wheel->fired_type[f] = wheel->type[timer];
+            wheel->fired_id[f] = wheel->id[timer];
+            wheel->fired_expire_at[f] = wheel->expire_at[timer];
+            wheel->fired_count += 1;
+            wheel->next[timer] = wheel->first_free;
+            wheel->first_free = timer;
+            mark_row(&wheel->marks, timer);
+            timer = next;
+        }
+    }
 }
 
 struct Physics_States {
@@ -319,21 +1236,35 @@ struct Physics_States {
     bool* used;
     size_t curr_max;
     table_id_t* entity_id;
+    table_id_t* entity_index;
+    table_id_t first_free;
+    bool packed;
+    size_t column_count;
+    struct Table_Column* columns;
+    component_mask_t component;
+    struct Table_Changes* changes;
     float* x;
     float* y;
     float* x_speed;
     float* y_speed;
     float* angle;
+    // the state at the previous tick, for interpolation
+    float* prev_x;
+    float* prev_y;
+    float* prev_angle;
 };
 struct Physics_States* physics_states;
 void alloc_physics_states(size_t max_count) {
     physics_states = malloc(sizeof(struct Physics_States));
-    alloc_table(physics_states, max_count);
-    physics_states->x = malloc(max_count * sizeof(float));
-    physics_states->y = malloc(max_count * sizeof(float));
-    physics_states->x_speed = malloc(max_count * sizeof(float));
-    physics_states->y_speed = malloc(max_count * sizeof(float));
-    physics_states->angle = malloc(max_count * sizeof(float));
+    alloc_table(physics_states, max_count, true, COMPONENT_PHYSICS_STATE);
+    alloc_table_column(physics_states, &physics_states->x, sizeof(float));
+    alloc_table_column(physics_states, &physics_states->y, sizeof(float));
+    alloc_table_column(physics_states, &physics_states->x_speed, sizeof(float));
+    alloc_table_column(physics_states, &physics_states->y_speed, sizeof(float));
+    alloc_table_column(physics_states, &physics_states->angle, sizeof(float));
+    alloc_table_column(physics_states, &physics_states->prev_x, sizeof(float));
+    alloc_table_column(physics_states, &physics_states->prev_y, sizeof(float));
+    alloc_table_column(physics_states, &physics_states->prev_angle, sizeof(float));
 }
 table_id_t add_physics_state(table_id_t entity_id,
                              float x,       float y,
@@ -345,9 +1276,30 @@ table_id_t add_physics_state(table_id_t entity_id,
         physics_states->y[index] = y;
         physics_states->x_speed[index] = x_speed;
         physics_states->y_speed[index] = y_speed;
+        physics_states->angle[index] = 0;
+        // so a new entity doesn't get interpolated from garbage
+        physics_states->prev_x[index] = x;
+        physics_states->prev_y[index] = y;
+        physics_states->prev_angle[index] = 0;
     }
     return index;
 }
+// called at the start of every tick
+// the rows that moved last tick change again, their previous state catches up
+void save_prev_physics_states() {
+    const size_t count = physics_states->curr_max;
+    for (table_id_t i = 0; i < count; i += 1) {
+        if (physics_states->prev_x[i] != physics_states->x[i] ||
+            physics_states->prev_y[i] != physics_states->y[i] ||
+            physics_states->prev_angle[i] != physics_states->angle[i]) {
+
+            mark_item_changed(physics_states, i);
+        }
+    }
+    memcpy(physics_states->prev_x, physics_states->x, count * sizeof(float));
+    memcpy(physics_states->prev_y, physics_states->y, count * sizeof(float));
+    memcpy(physics_states->prev_angle, physics_states->angle, count * sizeof(float));
+}
 void remove_physics_state(table_id_t entity_id) {
     remove_table_item(physics_states, entity_id);
 }
@@ -362,15 +1314,22 @@ struct Physics_Balls {
     bool* used;
     size_t curr_max;
     table_id_t* entity_id;
+    table_id_t* entity_index;
+    table_id_t first_free;
+    bool packed;
+    size_t column_count;
+    struct Table_Column* columns;
+    component_mask_t component;
+    struct Table_Changes* changes;
     float* radius;
     float* mass;
 };
 struct Physics_Balls* physics_balls;
 void alloc_physics_balls(size_t max_count) {
     physics_balls = malloc(sizeof(struct Physics_Balls));
-    alloc_table(physics_balls, max_count);
-    physics_balls->radius = malloc(max_count * sizeof(float));
-    physics_balls->mass = malloc(max_count * sizeof(float));
+    alloc_table(physics_balls, max_count, true, COMPONENT_PHYSICS_BALL);
+    alloc_table_column(physics_balls, &physics_balls->radius, sizeof(float));
+    alloc_table_column(physics_balls, &physics_balls->mass, sizeof(float));
 }
 table_id_t add_physics_ball(table_id_t entity_id,
                             float radius, float mass) {
@@ -385,35 +1344,308 @@ void remove_physics_ball(table_id_t entity_id) {
     remove_table_item(physics_balls, entity_id);
 }
 
-// because we clear the collision table every frame
-// this can be a static table
-// with no table->used
-// an opportunity to profile
+// broadphase for step_physics_balls
+// balls are bucketed by the grid cell they're in,
+// cells are as big as the biggest ball,
+// so a ball can only touch balls in the 3x3 cells around it
+// the cells are hashed, so the world doesn't need bounds
+// the arrays are sized by physics_balls->max_count, so they grow with it
+struct Physics_Grid {
+    // power of two, so we can mask the hash
+    // sized by the live ball count, not max_count,
+    // so a big table with few balls doesn't clear buckets it never uses
+    // at most 4 * physics_balls->max_count - 1
+    size_t bucket_count;
+    float cell_size;
+    // counting sort of the balls by bucket
+    // balls of bucket b are bucket_items[bucket_start[b]..bucket_start[b+1]]
+    table_id_t* bucket_start;
+    table_id_t* bucket_items;
+    // per ball, cached while building
+    int* cell_x;
+    int* cell_y;
+    table_id_t* bucket;
+    table_id_t* physics_id;
+    // dying balls, and bullets that already hit an enemy this pass,
+    // they stay in the tables until the commands are flushed
+    bool* spent;
+    // per ball, the speed change from all of its overlaps
+    float* push_x;
+    float* push_y;
+    // per ball, how far the bullets that hit it knock it back,
+    // applied by step_physics once the grid is no longer read
+    float* knockback_x;
+    float* knockback_y;
+};
+struct Physics_Grid* physics_grid;
+void alloc_physics_grid(size_t max_count) {
+    physics_grid = malloc(sizeof(struct Physics_Grid));
+    physics_grid->bucket_count = 1;
+    physics_grid->cell_size = 1;
+    const size_t* count = &physics_balls->max_count;
+    // in the order build_physics_grid and step_physics touch them
+    arena_request_scratch(&physics_grid->physics_id, sizeof(table_id_t), count);
+    arena_request_scratch(&physics_grid->cell_x, sizeof(int), count);
+    arena_request_scratch(&physics_grid->cell_y, sizeof(int), count);
+    arena_request_scratch(&physics_grid->bucket, sizeof(table_id_t), count);
+    // bucket_count + 1 items
+    arena_request_scratch(&physics_grid->bucket_start, 4 * sizeof(table_id_t), count);
+    arena_request_scratch(&physics_grid->bucket_items, sizeof(table_id_t), count);
+    arena_request_scratch(&physics_grid->spent, sizeof(bool), count);
+    arena_request_scratch(&physics_grid->push_x, sizeof(float), count);
+    arena_request_scratch(&physics_grid->push_y, sizeof(float), count);
+    arena_request_scratch(&physics_grid->knockback_x, sizeof(float), count);
+    arena_request_scratch(&physics_grid->knockback_y, sizeof(float), count);
+}
+table_id_t get_grid_bucket(int cell_x, int cell_y) {
+    const uint hash = ((uint)cell_x * 73856093u) ^ ((uint)cell_y * 19349663u);
+    return hash & (physics_grid->bucket_count - 1);
+}
+// call again whenever positions or balls change
+void build_physics_grid() {
+    struct Physics_Grid* grid = physics_grid;
+
+    float max_radius = 0;
+    for (table_id_t i = 0; i < physics_balls->curr_max; i += 1) {
+        if (physics_balls->radius[i] > max_radius) {
+            max_radius = physics_balls->radius[i];
+        }
+    }
+    // touching balls are less than two radiuses apart
+    grid->cell_size = max_radius * 2;
+    if (grid->cell_size <= 0) {
+        grid->cell_size = 1;
+    }
+    grid->bucket_count = 1;
+    while (grid->bucket_count < physics_balls->curr_max * 2) {
+        grid->bucket_count *= 2;
+    }
+
+    for (size_t b = 0; b <= grid->bucket_count; b += 1) {
+        grid->bucket_start[b] = 0;
+    }
+    for (table_id_t i = 0; i < physics_balls->curr_max; i += 1) {
+        const table_id_t physics_id = find_item_index(physics_states, physics_balls->entity_id[i]);
+        grid->physics_id[i] = physics_id;
+        grid->spent[i] = has_components(physics_balls->entity_id[i], COMPONENT_DYING);
+        grid->knockback_x[i] = 0;
+        grid->knockback_y[i] = 0;
+        if (physics_id < physics_states->curr_max) {
+            grid->cell_x[i] = (int)floorf(physics_states->x[physics_id] / grid->cell_size);
+            grid->cell_y[i] = (int)floorf(physics_states->y[physics_id] / grid->cell_size);
+            grid->bucket[i] = get_grid_bucket(grid->cell_x[i], grid->cell_y[i]);
+            grid->bucket_start[grid->bucket[i] + 1] += 1;
+        }
+    }
+    for (size_t b = 0; b < grid->bucket_count; b += 1) {
+        grid->bucket_start[b + 1] += grid->bucket_start[b];
+    }
+    // bucket_start[b] is used as the write cursor,
+    // which leaves it at the start of bucket b+1
+    for (table_id_t i = 0; i < physics_balls->curr_max; i += 1) {
+        if (grid->physics_id[i] < physics_states->curr_max) {
+            grid->bucket_items[grid->bucket_start[grid->bucket[i]]] = i;
+            grid->bucket_start[grid->bucket[i]] += 1;
+        }
+    }
+    for (size_t b = grid->bucket_count; b > 0; b -= 1) {
+        grid->bucket_start[b] = grid->bucket_start[b - 1];
+    }
+    grid->bucket_start[0] = 0;
+}
+
+// the contacts of the current tick, cleared at the start of every tick
+// physics adds pairs with add_collision_item,
+// a pair is kept once, however many times it touches,
+// then finish_collision_table indexes the pairs by entity,
+// so find_contacts answers who an entity touched in O(its contacts)
 struct Collision_Table {
     size_t max_count;
-    bool* used;
-    size_t curr_max;
+    size_t count;
     table_id_t* entity_id;
     table_id_t* entity_id_2;
+    // pairs hashed by their (min, max) entity,
+    // power of two, at most 4 * max_count, kept at most half full
+    // sized by the last tick's pairs, not max_count,
+    // so one crowded tick doesn't leave a hash too big for the cache
+    size_t bucket_count;
+    // pair index + 1, so the zeroed arena is an empty hash
+    table_id_t* buckets;
+    // per pair, so clearing only touches the buckets in use
+    table_id_t* pair_bucket;
+    // per entity slot, the entities it touched are
+    // contacts[contact_start[slot]..contact_start[slot] + contact_count[slot]]
+    // contact_count is 0 for every slot without pairs
+    table_id_t* contact_start;
+    table_id_t* contact_count;
+    // the slot's entity when it was indexed
+    table_id_t* contact_entity_id;
+    // per pair end, filled by finish_collision_table
+    table_id_t* contacts;
 };
 struct Collision_Table* collision_table;
+#define MIN_COLLISION_BUCKET_COUNT 64
 void alloc_collision_table(size_t max_count) {
     collision_table = malloc(sizeof(struct Collision_Table));
-    alloc_table(collision_table, max_count);
-    collision_table->entity_id_2 = malloc(max_count * sizeof(table_id_t));
+    struct Collision_Table* table = collision_table;
+    // room for MIN_COLLISION_BUCKET_COUNT buckets
+    if (max_count < MIN_COLLISION_BUCKET_COUNT / 4) {
+        max_count = MIN_COLLISION_BUCKET_COUNT / 4;
+    }
+    table->max_count = max_count;
+    table->count = 0;
+    table->bucket_count = MIN_COLLISION_BUCKET_COUNT;
+    arena_request_scratch(&table->entity_id, sizeof(table_id_t), &table->max_count);
+    arena_request_scratch(&table->entity_id_2, sizeof(table_id_t), &table->max_count);
+    arena_request_scratch(&table->buckets, 4 * sizeof(table_id_t), &table->max_count);
+    arena_request_scratch(&table->pair_bucket, sizeof(table_id_t), &table->max_count);
+    arena_request_scratch(&table->contact_start, sizeof(table_id_t), &max_entity_count);
+    arena_request_scratch(&table->contact_count, sizeof(table_id_t), &max_entity_count);
+    arena_request_scratch(&table->contact_entity_id, sizeof(table_id_t), &max_entity_count);
+    arena_request_scratch(&table->contacts, 2 * sizeof(table_id_t), &table->max_count);
 }
-table_id_t add_collision_item(table_id_t entity_id, table_id_t entity_id_2) {
-    table_id_t index = add_table_item(collision_table, entity_id);
-    if (index < collision_table->max_count) {
-        collision_table->entity_id_2[index] = entity_id_2;
+table_id_t get_collision_bucket(table_id_t entity_id, table_id_t entity_id_2) {
+    const table_id_t low = entity_id < entity_id_2 ? entity_id : entity_id_2;
+    const table_id_t high = entity_id < entity_id_2 ? entity_id_2 : entity_id;
+    const uint hash = (low * 2654435761u) ^ (high * 40503u);
+    return hash & (collision_table->bucket_count - 1);
+}
+// the bucket that holds the pair, or the empty bucket it would go in
+table_id_t find_collision_bucket(table_id_t entity_id, table_id_t entity_id_2) {
+    const struct Collision_Table* table = collision_table;
+    table_id_t bucket = get_collision_bucket(entity_id, entity_id_2);
+    while (table->buckets[bucket] != 0) {
+        const table_id_t pair = table->buckets[bucket] - 1;
+        if ((table->entity_id[pair] == entity_id && table->entity_id_2[pair] == entity_id_2) ||
+            (table->entity_id[pair] == entity_id_2 && table->entity_id_2[pair] == entity_id)) {
+
+            break;
+        }
+        bucket = (bucket + 1) & (table->bucket_count - 1);
     }
-    return index;
+    return bucket;
+}
+void rehash_collision_table(size_t bucket_count) {
+    struct Collision_Table* table = collision_table;
+    table->bucket_count = bucket_count;
+    memset(table->buckets, 0, table->bucket_count * sizeof(table_id_t));
+    for (table_id_t pair = 0; pair < table->count; pair += 1) {
+        const table_id_t bucket = find_collision_bucket(table->entity_id[pair], table->entity_id_2[pair]);
+        table->buckets[bucket] = pair + 1;
+        table->pair_bucket[pair] = bucket;
+    }
+}
+// doubles the capacity
+// returns false if there's no memory
+bool grow_collision_table() {
+    struct Collision_Table* table = collision_table;
+    const size_t max_count = table->max_count;
+    table->max_count = max_count * 2;
+    if (!arena_regrow()) {
+        table->max_count = max_count;
+        return false;
+    }
+    return true;
+}
+// a full table grows
+// returns false if there's no memory to grow
+bool add_collision_item(table_id_t entity_id, table_id_t entity_id_2) {
+    struct Collision_Table* table = collision_table;
+    table_id_t bucket = find_collision_bucket(entity_id, entity_id_2);
+    if (table->buckets[bucket] != 0) {
+        return true;
+    }
+    if (table->count == table->max_count && !grow_collision_table()) {
+        return false;
+    }
+    if ((table->count + 1) * 2 > table->bucket_count) {
+        rehash_collision_table(table->bucket_count * 2);
+        bucket = find_collision_bucket(entity_id, entity_id_2);
+    }
+    const table_id_t pair = table->count;
+    table->count += 1;
+    table->entity_id[pair] = entity_id;
+    table->entity_id_2[pair] = entity_id_2;
+    table->buckets[bucket] = pair + 1;
+    table->pair_bucket[pair] = bucket;
+    return true;
+}
+// builds the contact index, call after the last add_collision_item of the tick
+// a counting sort of the pair ends by entity slot,
+// in the order the slots first show up
+void finish_collision_table() {
+    struct Collision_Table* table = collision_table;
+    for (table_id_t pair = 0; pair < table->count; pair += 1) {
+        table->contact_count[get_entity_slot(table->entity_id[pair])] += 1;
+        table->contact_count[get_entity_slot(table->entity_id_2[pair])] += 1;
+    }
+    // contact_start is 0 until a slot gets its range,
+    // it's left at the end of the range, and the fill walks it back
+    table_id_t cursor = 0;
+    for (table_id_t pair = 0; pair < table->count; pair += 1) {
+        const table_id_t ends[2] = {table->entity_id[pair], table->entity_id_2[pair]};
+        for (size_t e = 0; e < 2; e += 1) {
+            const table_id_t slot = get_entity_slot(ends[e]);
+            if (table->contact_start[slot] == 0) {
+                cursor += table->contact_count[slot];
+                table->contact_start[slot] = cursor;
+                table->contact_entity_id[slot] = ends[e];
+            }
+        }
+    }
+    for (table_id_t pair = 0; pair < table->count; pair += 1) {
+        const table_id_t slot = get_entity_slot(table->entity_id[pair]);
+        const table_id_t slot_2 = get_entity_slot(table->entity_id_2[pair]);
+        table->contact_start[slot] -= 1;
+        table->contacts[table->contact_start[slot]] = table->entity_id_2[pair];
+        table->contact_start[slot_2] -= 1;
+        table->contacts[table->contact_start[slot_2]] = table->entity_id[pair];
+    }
+}
+// returns how many entities this one touched this tick,
+// they're collision_table->contacts[*start..*start + count]
+// read contacts through collision_table, adding to a table can move it
+table_id_t find_contacts(table_id_t entity_id, table_id_t* start) {
+    const struct Collision_Table* table = collision_table;
+    const table_id_t slot = get_entity_slot(entity_id);
+    *start = 0;
+    if (slot >= max_entity_count ||
+        table->contact_count[slot] == 0 ||
+        table->contact_entity_id[slot] != entity_id) {
+
+        return 0;
+    }
+    *start = table->contact_start[slot];
+    return table->contact_count[slot];
 }
+// only touches what the last tick used,
+// and sizes the hash for about as many pairs
 void clear_collision_table() {
-    for (table_id_t i = 0; i < collision_table->curr_max; i += 1) {
-        collision_table->used[i] = false;
+    struct Collision_Table* table = collision_table;
+    // a crowded hash is faster to clear in one go
+    if (table->count * 8 > table->bucket_count) {
+        memset(table->buckets, 0, table->bucket_count * sizeof(table_id_t));
+    }
+    else {
+        for (table_id_t pair = 0; pair < table->count; pair += 1) {
+            table->buckets[table->pair_bucket[pair]] = 0;
+        }
+    }
+    for (table_id_t pair = 0; pair < table->count; pair += 1) {
+        const table_id_t slot = get_entity_slot(table->entity_id[pair]);
+        const table_id_t slot_2 = get_entity_slot(table->entity_id_2[pair]);
+        table->contact_start[slot] = 0;
+        table->contact_count[slot] = 0;
+        table->contact_start[slot_2] = 0;
+        table->contact_count[slot_2] = 0;
+    }
+    // the buckets are all empty, so any size is a valid hash
+    size_t bucket_count = MIN_COLLISION_BUCKET_COUNT;
+    while (bucket_count < table->count * 2) {
+        bucket_count *= 2;
     }
-    collision_table->curr_max = 0;
+    table->bucket_count = bucket_count;
+    table->count = 0;
 }
 
 EMSCRIPTEN_KEEPALIVE
@@ -426,15 +1658,37 @@ struct Proximity_Attack {
     bool* used;
     size_t curr_max;
     table_id_t* entity_id;
+    table_id_t* entity_index;
+    table_id_t first_free;
+    bool packed;
+    size_t column_count;
+    struct Table_Column* columns;
+    component_mask_t component;
+    struct Table_Changes* changes;
+    // counts down at PROXIMITY_ATTACK_SPEED from a bite's 100,
+    // but only changes when its timers fire:
+    // PROXIMITY_ATTACK_PREPARE when the zombie gets ready to bite,
+    // and 0 when it can bite again
     float* attack_state;
     float* damage;
 };
 struct Proximity_Attack* proximity_attack;
 void alloc_proximity_attack(size_t max_count) {
     proximity_attack = malloc(sizeof(struct Proximity_Attack));
-    alloc_table(proximity_attack, max_count);
-    proximity_attack->attack_state = malloc(max_count * sizeof(float));
-    proximity_attack->damage = malloc(max_count * sizeof(float));
+    alloc_table(proximity_attack, max_count, true, COMPONENT_PROXIMITY_ATTACK);
+    alloc_table_column(proximity_attack, &proximity_attack->attack_state, sizeof(float));
+    alloc_table_column(proximity_attack, &proximity_attack->damage, sizeof(float));
+}
+// registers the timer for the next step of attack_state
+void schedule_proximity_attack(table_id_t entity_id, float attack_state) {
+    if (attack_state > PROXIMITY_ATTACK_PREPARE) {
+        add_timer(TIMER_PROXIMITY_PREPARE, entity_id,
+                  get_time_ms_after((attack_state - PROXIMITY_ATTACK_PREPARE) / PROXIMITY_ATTACK_SPEED));
+    }
+    else if (attack_state > 0) {
+        add_timer(TIMER_PROXIMITY_READY, entity_id,
+                  get_time_ms_after(attack_state / PROXIMITY_ATTACK_SPEED));
+    }
 }
 table_id_t add_proximity_attack(table_id_t entity_id,
                                 float attack_state, float damage) {
@@ -442,6 +1696,7 @@ table_id_t add_proximity_attack(table_id_t entity_id,
     if (index < proximity_attack->max_count) {
         proximity_attack->attack_state[index] = attack_state;
         proximity_attack->damage[index] = damage;
+        schedule_proximity_attack(entity_id, attack_state);
     }
     return index;
 }
@@ -455,26 +1710,60 @@ struct Hit_Feedback_Table {
     bool* used;
     size_t curr_max;
     table_id_t* entity_id;
+    table_id_t* entity_index;
+    table_id_t first_free;
+    bool packed;
+    size_t column_count;
+    struct Table_Column* columns;
+    component_mask_t component;
+    struct Table_Changes* changes;
+    // at the hit, fades at HIT_FEEDBACK_SPEED
     float* amount;
+    // when the fade ends and its timer removes the item
+    uint64_t* expire_at;
 };
 struct Hit_Feedback_Table* hit_feedback_table;
 void alloc_hit_feedback_table(size_t max_count) {
     hit_feedback_table = malloc(sizeof(struct Hit_Feedback_Table));
-    alloc_table(hit_feedback_table, max_count);
-    hit_feedback_table->amount = malloc(max_count * sizeof(float));
+    alloc_table(hit_feedback_table, max_count, true, COMPONENT_HIT_FEEDBACK);
+    alloc_table_column(hit_feedback_table, &hit_feedback_table->amount, sizeof(float));
+    alloc_table_column(hit_feedback_table, &hit_feedback_table->expire_at, sizeof(uint64_t));
 }
+void refresh_sprite_variant(table_id_t entity_id);
 table_id_t add_hit_feedback_item(table_id_t entity_id, float amount) {
-    table_id_t index = add_table_item(hit_feedback_table, entity_id);
+    // an entity that gets hit again restarts its feedback
+    // instead of getting a second item
+    table_id_t index = find_item_index(hit_feedback_table, entity_id);
+    if (index == hit_feedback_table->curr_max) {
+        index = add_table_item(hit_feedback_table, entity_id);
+    }
     if (index < hit_feedback_table->max_count) {
+        const uint64_t expire_at = get_time_ms_after(amount / HIT_FEEDBACK_SPEED);
         hit_feedback_table->amount[index] = amount;
+        hit_feedback_table->expire_at[index] = expire_at;
+        mark_item_changed(hit_feedback_table, index);
+        // the timer of the earlier hit sees a different expire_at
+        add_timer(TIMER_HIT_FEEDBACK, entity_id, expire_at);
+        refresh_sprite_variant(entity_id);
     }
     return index;
 }
-void clear_hit_feedback_table() {
-    for (table_id_t i = 0; i < hit_feedback_table->curr_max; i += 1) {
-        hit_feedback_table->used[i] = false;
+// the timer finds no item and does nothing
+void remove_hit_feedback_item(table_id_t entity_id) {
+    remove_table_item(hit_feedback_table, entity_id);
+}
+// what's left of the fade now
+float get_hit_feedback_amount(table_id_t index) {
+    const uint64_t now = get_time_ms();
+    const uint64_t expire_at = hit_feedback_table->expire_at[index];
+    if (now >= expire_at) {
+        return 0;
     }
-    hit_feedback_table->curr_max = 0;
+    const float amount = (expire_at - now) / 1000.0f * HIT_FEEDBACK_SPEED;
+    return fminf(amount, hit_feedback_table->amount[index]);
+}
+void clear_hit_feedback_table() {
+    clear_table(hit_feedback_table);
 }
 
 EMSCRIPTEN_KEEPALIVE
@@ -487,6 +1776,13 @@ struct Sprite_Map {
     bool* used;
     size_t curr_max;
     table_id_t* entity_id;
+    table_id_t* entity_index;
+    table_id_t first_free;
+    bool packed;
+    size_t column_count;
+    struct Table_Column* columns;
+    component_mask_t component;
+    struct Table_Changes* changes;
     sprite_id_t*      sprite_id;
     sprite_origin_t*  sprite_origin_x;
     sprite_origin_t*  sprite_origin_y;
@@ -496,12 +1792,12 @@ struct Sprite_Map {
 struct Sprite_Map* sprite_map;
 void alloc_sprite_map(size_t max_count) {
     sprite_map = malloc(sizeof(struct Sprite_Map));
-    alloc_table(sprite_map, max_count);
-    sprite_map->sprite_id = malloc(max_count * sizeof(sprite_id_t));
-    sprite_map->sprite_origin_x = malloc(max_count * sizeof(sprite_origin_t));
-    sprite_map->sprite_origin_y = malloc(max_count * sizeof(sprite_origin_t));
-    sprite_map->sprite_size = malloc(max_count * sizeof(sprite_size_t));
-    sprite_map->sprite_variant = malloc(max_count * sizeof(sprite_variant_t));
+    alloc_table(sprite_map, max_count, true, COMPONENT_SPRITE_MAP);
+    alloc_table_column(sprite_map, &sprite_map->sprite_id, sizeof(sprite_id_t));
+    alloc_table_column(sprite_map, &sprite_map->sprite_origin_x, sizeof(sprite_origin_t));
+    alloc_table_column(sprite_map, &sprite_map->sprite_origin_y, sizeof(sprite_origin_t));
+    alloc_table_column(sprite_map, &sprite_map->sprite_size, sizeof(sprite_size_t));
+    alloc_table_column(sprite_map, &sprite_map->sprite_variant, sizeof(sprite_variant_t));
 }
 table_id_t add_sprite_map(table_id_t entity_id, sprite_id_t sprite_id,
                           sprite_origin_t sprite_origin_x, sprite_origin_t sprite_origin_y,
@@ -520,10 +1816,32 @@ table_id_t add_sprite_map(table_id_t entity_id, sprite_id_t sprite_id,
 void remove_sprite_map(table_id_t entity_id) {
     remove_table_item(sprite_map, entity_id);
 }
-
-EMSCRIPTEN_KEEPALIVE
-struct Sprite_Map* get_sprite_map() {
-    return sprite_map;
+// 1 while hit, 2 while getting ready to bite, 0 otherwise
+// call when any of those change
+void refresh_sprite_variant(table_id_t entity_id) {
+    const table_id_t sprite_map_id = find_item_index(sprite_map, entity_id);
+    if (sprite_map_id == sprite_map->curr_max) {
+        return;
+    }
+    sprite_variant_t sprite_variant = 0;
+    if (has_components(entity_id, COMPONENT_HIT_FEEDBACK)) {
+        sprite_variant = 1;
+    }
+    else if (has_components(entity_id, COMPONENT_PROXIMITY_ATTACK)) {
+        const table_id_t proximity_attack_id = find_item_index(proximity_attack, entity_id);
+        if (proximity_attack->attack_state[proximity_attack_id] <= PROXIMITY_ATTACK_PREPARE) {
+            sprite_variant = 2;
+        }
+    }
+    if (sprite_map->sprite_variant[sprite_map_id] != sprite_variant) {
+        sprite_map->sprite_variant[sprite_map_id] = sprite_variant;
+        mark_item_changed(sprite_map, sprite_map_id);
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE
+struct Sprite_Map* get_sprite_map() {
+    return sprite_map;
 }
 
 struct AI_Enemy {
@@ -531,18 +1849,34 @@ struct AI_Enemy {
     bool* used;
     size_t curr_max;
     table_id_t* entity_id;
+    table_id_t* entity_index;
+    table_id_t first_free;
+    bool packed;
+    size_t column_count;
+    struct Table_Column* columns;
+    component_mask_t component;
+    struct Table_Changes* changes;
     enemy_type_t* enemy_type;
+    // rows of the entity in other tables, kept between ticks,
+    // see `find_cached_item_index`
+    table_id_t* physics_id;
+    table_id_t* health_id;
 };
 struct AI_Enemy* ai_enemy;
 void alloc_ai_enemy(size_t max_count) {
     ai_enemy = malloc(sizeof(struct AI_Enemy));
-    alloc_table(ai_enemy, max_count);
-    ai_enemy->enemy_type = malloc(max_count * sizeof(enemy_type_t));
+    alloc_table(ai_enemy, max_count, true, COMPONENT_AI_ENEMY);
+    alloc_table_column(ai_enemy, &ai_enemy->enemy_type, sizeof(enemy_type_t));
+    alloc_table_column(ai_enemy, &ai_enemy->physics_id, sizeof(table_id_t));
+    alloc_table_column(ai_enemy, &ai_enemy->health_id, sizeof(table_id_t));
 }
 table_id_t add_ai_enemy(table_id_t entity_id, enemy_type_t enemy_type) {
     table_id_t index = add_table_item(ai_enemy, entity_id);
     if (index < ai_enemy->max_count) {
         ai_enemy->enemy_type[index] = enemy_type;
+        // the first lookup fills them in
+        ai_enemy->physics_id[index] = 0;
+        ai_enemy->health_id[index] = 0;
     }
 
     return index;
@@ -556,11 +1890,157 @@ struct AI_Enemy* get_ai_enemy() {
     return ai_enemy;
 }
 
+// a grid over the enemies, rebuilt by `step_ai_enemy`,
+// so an enemy reads a few nodes around it instead of visiting every other enemy
+// nodes are the corners of the cells, values between them are interpolated
+// density is the enemies splatted onto their four nodes
+// cells are AI_ENEMY_PREFERRED_DISTANCE wide, whatever the capacities,
+// so the same world always steers the same way
+// there are no walls, so the way to the player is the straight line
+// and needs no grid, with walls, a flow field would go here
+struct AI_Field {
+    float cell_size;
+    // where node (0, 0) is
+    float origin_x;
+    float origin_y;
+    int width;
+    int height;
+    float* density;
+};
+struct AI_Field* ai_field;
+void alloc_ai_field() {
+    ai_field = malloc(sizeof(struct AI_Field));
+    ai_field->width = 0;
+    ai_field->height = 0;
+    ai_field->cell_size = AI_ENEMY_PREFERRED_DISTANCE;
+    arena_request_scratch(&ai_field->density, sizeof(float) * AI_FIELD_MAX_NODES, NULL);
+}
+// 0 outside the field
+float get_ai_field_node(const float* values, int node_x, int node_y) {
+    const struct AI_Field* field = ai_field;
+    if (node_x < 0 || node_x >= field->width ||
+        node_y < 0 || node_y >= field->height) {
+        return 0;
+    }
+    return values[node_y * field->width + node_x];
+}
+// the node at the top left of the cell x, y is in, and where in the cell, from 0 to 1
+void get_ai_field_cell(float x, float y, int* node_x, int* node_y, float* t_x, float* t_y) {
+    const struct AI_Field* field = ai_field;
+    const float cell_x = (x - field->origin_x) / field->cell_size;
+    const float cell_y = (y - field->origin_y) / field->cell_size;
+    *node_x = (int)floorf(cell_x);
+    *node_y = (int)floorf(cell_y);
+    *t_x = cell_x - *node_x;
+    *t_y = cell_y - *node_y;
+}
+// the central difference at each of the four nodes, interpolated
+// an enemy's own splat cancels out, so it only feels the others
+void sample_ai_field_gradient(const float* values, float x, float y, float* gradient_x, float* gradient_y) {
+    int node_x, node_y;
+    float t_x, t_y;
+    get_ai_field_cell(x, y, &node_x, &node_y, &t_x, &t_y);
+    *gradient_x = 0;
+    *gradient_y = 0;
+    for (int k = 0; k < 4; k += 1) {
+        const int n_x = node_x + (k & 1);
+        const int n_y = node_y + (k >> 1);
+        const float weight = ((k & 1) ? t_x : 1 - t_x) * ((k >> 1) ? t_y : 1 - t_y);
+        *gradient_x += weight * (get_ai_field_node(values, n_x + 1, n_y) -
+                                 get_ai_field_node(values, n_x - 1, n_y)) / 2;
+        *gradient_y += weight * (get_ai_field_node(values, n_x, n_y + 1) -
+                                 get_ai_field_node(values, n_x, n_y - 1)) / 2;
+    }
+}
+// sizes the field to the enemies,
+// up to AI_FIELD_RADIUS cells around the player
+void build_ai_field(float player_x, float player_y) {
+    struct AI_Field* field = ai_field;
+    if (ai_enemy->curr_max == 0) {
+        field->width = 0;
+        field->height = 0;
+        return;
+    }
+    float min_x = FLT_MAX;
+    float min_y = FLT_MAX;
+    float max_x = -FLT_MAX;
+    float max_y = -FLT_MAX;
+    for (table_id_t i = 0; i < ai_enemy->curr_max; i += 1) {
+        const table_id_t physics_id = find_cached_item_index(physics_states, ai_enemy->entity_id[i],
+                                                                 ai_enemy, i, &ai_enemy->physics_id[i]);
+        const float x = physics_states->x[physics_id];
+        const float y = physics_states->y[physics_id];
+        if (x < min_x) {
+            min_x = x;
+        }
+        if (x > max_x) {
+            max_x = x;
+        }
+        if (y < min_y) {
+            min_y = y;
+        }
+        if (y > max_y) {
+            max_y = y;
+        }
+    }
+    // two nodes to spare, at most AI_FIELD_RADIUS cells from the player's
+    const float player_cell_x = floorf(player_x / field->cell_size);
+    const float player_cell_y = floorf(player_y / field->cell_size);
+    float first_x = floorf(min_x / field->cell_size) - 2;
+    float first_y = floorf(min_y / field->cell_size) - 2;
+    float last_x = floorf(max_x / field->cell_size) + 3;
+    float last_y = floorf(max_y / field->cell_size) + 3;
+    first_x = fmaxf(first_x, player_cell_x - AI_FIELD_RADIUS);
+    first_y = fmaxf(first_y, player_cell_y - AI_FIELD_RADIUS);
+    last_x = fminf(last_x, player_cell_x + AI_FIELD_RADIUS);
+    last_y = fminf(last_y, player_cell_y + AI_FIELD_RADIUS);
+    // every enemy is out of reach
+    if (first_x > last_x || first_y > last_y) {
+        field->width = 0;
+        field->height = 0;
+        return;
+    }
+    field->origin_x = first_x * field->cell_size;
+    field->origin_y = first_y * field->cell_size;
+    field->width = last_x - first_x + 1;
+    field->height = last_y - first_y + 1;
+}
+// dying enemies are left out
+void build_ai_density() {
+    struct AI_Field* field = ai_field;
+    memset(field->density, 0, (size_t)field->width * field->height * sizeof(float));
+    for (table_id_t i = 0; i < ai_enemy->curr_max; i += 1) {
+        if (has_components(ai_enemy->entity_id[i], COMPONENT_DYING)) {
+            continue;
+        }
+        const table_id_t physics_id = ai_enemy->physics_id[i];
+        int node_x, node_y;
+        float t_x, t_y;
+        get_ai_field_cell(physics_states->x[physics_id], physics_states->y[physics_id],
+                          &node_x, &node_y, &t_x, &t_y);
+        for (int k = 0; k < 4; k += 1) {
+            const int n_x = node_x + (k & 1);
+            const int n_y = node_y + (k >> 1);
+            if (n_x >= 0 && n_x < field->width && n_y >= 0 && n_y < field->height) {
+                field->density[n_y * field->width + n_x] +=
+                    ((k & 1) ? t_x : 1 - t_x) * ((k >> 1) ? t_y : 1 - t_y);
+            }
+        }
+    }
+}
+
 struct Bullet_Table {
     size_t max_count;
     bool* used;
     size_t curr_max;
     table_id_t* entity_id;
+    table_id_t* entity_index;
+    table_id_t first_free;
+    bool packed;
+    size_t column_count;
+    struct Table_Column* columns;
+    component_mask_t component;
+    struct Table_Changes* changes;
     float* damage;
     struct timespec* created_at;
     // maybe type?
@@ -568,9 +2048,9 @@ struct Bullet_Table {
 struct Bullet_Table* bullets;
 void alloc_bullets(size_t max_count) {
     bullets = malloc(sizeof(struct Bullet_Table));
-    alloc_table(bullets, max_count);
-    bullets->damage = malloc(max_count * sizeof(float));
-    bullets->created_at = malloc(max_count * sizeof(struct timespec));
+    alloc_table(bullets, max_count, true, COMPONENT_BULLET);
+    alloc_table_column(bullets, &bullets->damage, sizeof(float));
+    alloc_table_column(bullets, &bullets->created_at, sizeof(struct timespec));
 }
 table_id_t add_bullet(table_id_t entity_id,
                       float damage, struct timespec created_at) {
@@ -580,6 +2060,8 @@ table_id_t add_bullet(table_id_t entity_id,
     if (index < bullets->max_count) {
         bullets->damage[index] = damage;
         bullets->created_at[index] = created_at;
+        add_timer(TIMER_BULLET_LIFETIME, entity_id,
+                  timespec_to_ms(&created_at) + BULLET_LIFETIME * 1000);
     }
 
     return index;
@@ -593,15 +2075,22 @@ struct Health_Table {
     bool* used;
     size_t curr_max;
     table_id_t* entity_id;
+    table_id_t* entity_index;
+    table_id_t first_free;
+    bool packed;
+    size_t column_count;
+    struct Table_Column* columns;
+    component_mask_t component;
+    struct Table_Changes* changes;
     float* health_points;
     struct timespec* last_hit_at;
 };
 struct Health_Table* health_table;
 void alloc_health_table(size_t max_count) {
     health_table = malloc(sizeof(struct Health_Table));
-    alloc_table(health_table, max_count);
-    health_table->health_points = malloc(max_count * sizeof(float));
-    health_table->last_hit_at = malloc(max_count * sizeof(struct timespec));
+    alloc_table(health_table, max_count, true, COMPONENT_HEALTH);
+    alloc_table_column(health_table, &health_table->health_points, sizeof(float));
+    alloc_table_column(health_table, &health_table->last_hit_at, sizeof(struct timespec));
 }
 table_id_t add_health_item(table_id_t entity_id,
                            float health_points,
@@ -650,8 +2139,68 @@ void get_angle_to_point(float  x,  float  y,
     *angle = atan2(*dir_y, *dir_x);
 }
 
+// SIMD
+// the per-row float loops are written once against these wrappers,
+// the instruction set is picked at build time:
+// wasm simd128 with -msimd128, AVX with -mavx, SSE with -msse2,
+// and SHOOTER_SCALAR forces the scalar fallback
+// loads and stores are unaligned,
+// columns start on a cache line but callers may pass any offset
+#if !defined(SHOOTER_SCALAR) && defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define SIMD_WIDTH 4
+typedef v128_t simd_float;
+simd_float simd_load(const float* p)             { return wasm_v128_load(p); }
+void       simd_store(float* p, simd_float a)    { wasm_v128_store(p, a); }
+simd_float simd_set1(float a)                    { return wasm_f32x4_splat(a); }
+simd_float simd_add(simd_float a, simd_float b)  { return wasm_f32x4_add(a, b); }
+simd_float simd_mul(simd_float a, simd_float b)  { return wasm_f32x4_mul(a, b); }
+#elif !defined(SHOOTER_SCALAR) && defined(__AVX__)
+#include <immintrin.h>
+#define SIMD_WIDTH 8
+typedef __m256 simd_float;
+simd_float simd_load(const float* p)             { return _mm256_loadu_ps(p); }
+void       simd_store(float* p, simd_float a)    { _mm256_storeu_ps(p, a); }
+simd_float simd_set1(float a)                    { return _mm256_set1_ps(a); }
+simd_float simd_add(simd_float a, simd_float b)  { return _mm256_add_ps(a, b); }
+simd_float simd_mul(simd_float a, simd_float b)  { return _mm256_mul_ps(a, b); }
+#elif !defined(SHOOTER_SCALAR) && defined(__SSE2__)
+#include <emmintrin.h>
+#define SIMD_WIDTH 4
+typedef __m128 simd_float;
+simd_float simd_load(const float* p)             { return _mm_loadu_ps(p); }
+void       simd_store(float* p, simd_float a)    { _mm_storeu_ps(p, a); }
+simd_float simd_set1(float a)                    { return _mm_set1_ps(a); }
+simd_float simd_add(simd_float a, simd_float b)  { return _mm_add_ps(a, b); }
+simd_float simd_mul(simd_float a, simd_float b)  { return _mm_mul_ps(a, b); }
+#else
+#define SIMD_WIDTH 1
+typedef float simd_float;
+simd_float simd_load(const float* p)             { return *p; }
+void       simd_store(float* p, simd_float a)    { *p = a; }
+simd_float simd_set1(float a)                    { return a; }
+simd_float simd_add(simd_float a, simd_float b)  { return a + b; }
+simd_float simd_mul(simd_float a, simd_float b)  { return a * b; }
+#endif
+
+// value[i] += speed[i] * delta
+void simd_integrate(float* value, const float* speed, float delta, size_t count) {
+    const simd_float delta_v = simd_set1(delta);
+    size_t i = 0;
+    for (; i + SIMD_WIDTH <= count; i += SIMD_WIDTH) {
+        simd_store(&value[i], simd_add(simd_load(&value[i]),
+                                       simd_mul(simd_load(&speed[i]), delta_v)));
+    }
+    for (; i < count; i += 1) {
+        value[i] += speed[i] * delta;
+    }
+}
 table_id_t create_zombie(float x, float y) {
     const table_id_t entity_id = create_entity();
+    // out of memory
+    if (entity_id == NO_ENTITY) {
+        return entity_id;
+    }
     add_physics_state(entity_id, x, y, 0.0, 0.0);
     add_physics_ball(entity_id, 15, 2);
     add_sprite_map(entity_id, SPRITE_ZOMBIE, -20, -20, 40, 0);
@@ -668,10 +2217,18 @@ void destroy_zombie(table_id_t entity_id) {
     remove_sprite_map(entity_id);
     remove_ai_enemy(entity_id);
     remove_health_item(entity_id);
+    remove_proximity_attack(entity_id);
+    // a zombie killed while flashing would keep its item,
+    // and once its slot is reused the item can't be found to be removed
+    remove_hit_feedback_item(entity_id);
 }
 
 table_id_t create_player(float x, float y) {
     const table_id_t entity_id = create_entity();
+    // out of memory
+    if (entity_id == NO_ENTITY) {
+        return entity_id;
+    }
     add_physics_state(entity_id, x, y, 0.0, 0.0);
     add_physics_ball(entity_id, 15, 2);
     add_sprite_map(entity_id, SPRITE_PLAYER, -20, -20, 40, 0);
@@ -682,6 +2239,10 @@ table_id_t create_player(float x, float y) {
 
 table_id_t create_bullet(float x, float y, float x_speed, float y_speed) {
     const table_id_t entity_id = create_entity();
+    // out of memory
+    if (entity_id == NO_ENTITY) {
+        return entity_id;
+    }
     add_physics_state(entity_id, x, y, x_speed, y_speed);
     add_physics_ball(entity_id, 4, 1);
     add_sprite_map(entity_id, SPRITE_BULLET, -8, -8, 16, 0);
@@ -697,35 +2258,80 @@ void destroy_bullet(table_id_t entity_id) {
     remove_bullet(entity_id);
 }
 
+enum Command_Type {
+    COMMAND_DESTROY_ZOMBIE,
+    COMMAND_DESTROY_BULLET
+};
+// destroys that systems queue while they iterate,
+// run together by flush_commands at one point of the tick,
+// so no system sees rows move under it
+// an entity is queued at most once, so max_entity_count commands always fit
+struct Command_Buffer {
+    size_t count;
+    unsigned char* type;
+    table_id_t* entity_id;
+};
+struct Command_Buffer* command_buffer;
+void alloc_command_buffer() {
+    command_buffer = malloc(sizeof(struct Command_Buffer));
+    command_buffer->count = 0;
+    arena_request_scratch(&command_buffer->type, sizeof(unsigned char), &max_entity_count);
+    arena_request_scratch(&command_buffer->entity_id, sizeof(table_id_t), &max_entity_count);
+}
+// marks the entity COMPONENT_DYING until the flush
+// returns false if it's already dying or removed,
+// so the caller can tell the first death from the rest
+bool queue_command(enum Command_Type type, table_id_t entity_id) {
+    if (!is_entity_alive(entity_id) ||
+        has_components(entity_id, COMPONENT_DYING)) {
+
+        return false;
+    }
+    assert(command_buffer->count < max_entity_count);
+    command_buffer->type[command_buffer->count] = type;
+    command_buffer->entity_id[command_buffer->count] = entity_id;
+    command_buffer->count += 1;
+    set_entity_components(entity_id, COMPONENT_DYING);
+    return true;
+}
+void flush_commands() {
+    for (size_t i = 0; i < command_buffer->count; i += 1) {
+        const table_id_t entity_id = command_buffer->entity_id[i];
+        // removed some other way since it was queued
+        if (!is_entity_alive(entity_id)) {
+            continue;
+        }
+        switch (command_buffer->type[i]) {
+            case COMMAND_DESTROY_ZOMBIE: destroy_zombie(entity_id); break;
+            case COMMAND_DESTROY_BULLET: destroy_bullet(entity_id); break;
+        }
+    }
+    command_buffer->count = 0;
+}
+
 struct Weapon_States {
     size_t max_count;
     size_t curr_max;
+    // MAX_FIRING_STATE from a shot until its TIMER_WEAPON_READY fires
     float* firing_state;
     float* firing_speed;
 };
 struct Weapon_States* weapon_states;
 void alloc_weapon_states(size_t max_count) {
     weapon_states = malloc(sizeof(struct Weapon_States));
-    weapon_states->firing_state = malloc(max_count * sizeof(float));
-    weapon_states->firing_speed = malloc(max_count * sizeof(float));
-    for (table_id_t i = 0; i < max_count; i += 1) {
-        weapon_states->firing_state[i] = 1;
-        weapon_states->firing_speed[i] = FIRING_SPEED;
-    }
     weapon_states->max_count = max_count;
+    arena_request(&weapon_states->firing_state, sizeof(float), &weapon_states->max_count);
+    arena_request(&weapon_states->firing_speed, sizeof(float), &weapon_states->max_count);
     weapon_states->curr_max = 1;
 }
-int curr_weapon = 0;
-void step_weapon_states(float delta) {
-    for (size_t i = 0; i < weapon_states->max_count; i += 1) {
-        if (weapon_states->firing_state[i] > 0) {
-            weapon_states->firing_state[i] -= weapon_states->firing_speed[i] * delta;
-        }
-        else {
-            weapon_states->firing_state[i] = 0;
-        }
+// after arena_commit
+void reset_weapon_states() {
+    for (table_id_t i = 0; i < weapon_states->max_count; i += 1) {
+        weapon_states->firing_state[i] = 0;
+        weapon_states->firing_speed[i] = FIRING_SPEED;
     }
 }
+int curr_weapon = 0;
 
 EMSCRIPTEN_KEEPALIVE
 struct Weapon_States* get_weapon_states() {
@@ -766,9 +2372,10 @@ struct Campaign* campaign;
 size_t curr_wave = 0;
 void alloc_campaign(size_t max_count) {
     campaign = malloc(sizeof(struct Campaign));
-    campaign->remaining = malloc(max_count * ENEMY_TYPE_COUNT * sizeof(enemy_count_t));
     campaign->curr_max = 0;
     campaign->max_count = max_count;
+    arena_request_rows(&campaign->remaining, ENEMY_TYPE_COUNT * sizeof(enemy_count_t), &campaign->max_count, &campaign->curr_max,
+                       NULL);
 }
 void add_campaign_wave(enemy_count_t remaining[ENEMY_TYPE_COUNT]) {
     for (size_t i = 0; i < ENEMY_TYPE_COUNT; i += 1) {
@@ -969,32 +2576,63 @@ EM_BOOL mouseup(int event_type, const struct EmscriptenMouseEvent* event, void*
     return consumed;
 }
 
+void alloc_profile_data();
+void alloc_draw_list(size_t max_count);
+void set_physics_thread_count(uint count);
+void build_system_graph();
+// max_count is the most entities the world can hold,
+// 0 picks DEFAULT_ENTITY_COUNT
+// returns false if there's no memory for that many
 EMSCRIPTEN_KEEPALIVE
-void init(const int width, const int height) {
+bool init(const int width, const int height, size_t max_count) {
     set_screen_size(width, height);
 
     start_time();
 
     wave_rest.rest_state = -0.01;
 
-    alloc_proximity_attack(MAX_ENTITY_COUNT);
-    alloc_hit_feedback_table(MAX_ENTITY_COUNT);
-    alloc_collision_table(MAX_ENTITY_COUNT); // times 2?
-    alloc_entity_table(MAX_ENTITY_COUNT);
-    alloc_physics_states(MAX_ENTITY_COUNT);
-    alloc_physics_balls(MAX_ENTITY_COUNT);
-    alloc_sprite_map(MAX_ENTITY_COUNT);
-    alloc_ai_enemy(MAX_ENTITY_COUNT);
-    alloc_bullets(MAX_ENTITY_COUNT);
-    alloc_health_table(MAX_ENTITY_COUNT);
-
+    if (max_count == 0) {
+        max_count = DEFAULT_ENTITY_COUNT;
+    }
+    if (max_count > MAX_ENTITY_SLOTS) {
+        max_count = MAX_ENTITY_SLOTS;
+    }
+    max_entity_count = max_count;
+
+    // the arena is laid out in request order,
+    // which is roughly the order tick touches the tables
+    alloc_entity_table(max_count);
+    alloc_physics_states(max_count);
+    alloc_physics_balls(max_count);
+    alloc_physics_grid(max_count);
+    alloc_collision_table(max_count); // times 2?
+    alloc_proximity_attack(max_count);
+    alloc_hit_feedback_table(max_count);
+    alloc_timer_wheel(max_count);
+    alloc_health_table(max_count);
     alloc_weapon_states(8);
+    alloc_ai_enemy(max_count);
+    alloc_ai_field();
+    alloc_bullets(max_count);
+    alloc_command_buffer();
+    alloc_sprite_map(max_count);
+    alloc_draw_list(max_count);
     alloc_campaign(20);
+    alloc_profile_data();
+    if (!arena_commit()) {
+        return false;
+    }
+
+    reset_timer_wheel();
+    reset_weapon_states();
     generate_campaign_waves();
+    build_system_graph();
+    set_physics_thread_count(0);
 
     alloc_overlay_data();
 
     input_state = malloc(sizeof(struct Input_State));
+    memset(input_state, 0, sizeof(struct Input_State));
 
     emscripten_set_keydown_callback(str_window, NULL, false, &keydown);
     emscripten_set_keyup_callback(str_window, NULL, false, &keyup);
@@ -1005,6 +2643,7 @@ void init(const int width, const int height) {
     create_player(screen_width / 2.0, screen_height / 2.0);
 
     start_wave();
+    return true;
 }
 
 uint score = 0;
@@ -1020,6 +2659,9 @@ void step_player(float delta) {
     const float y = physics_states->y[0];
 
     // movement
+    const float old_x_speed = physics_states->x_speed[0];
+    const float old_y_speed = physics_states->y_speed[0];
+    const float old_angle = physics_states->angle[0];
     if (input_state->move_up) {
         physics_states->y_speed[0] = -PLAYER_SPEED;
     }
@@ -1047,6 +2689,12 @@ void step_player(float delta) {
     get_angle_to_point(input_state->mouse_x, input_state->mouse_y, x, y,
                        &dx, &dy, &distance, &dir_x, &dir_y,
                        &physics_states->angle[0]);
+    // standing still and aiming changes the row too
+    if (x_speed != old_x_speed || y_speed != old_y_speed ||
+        physics_states->angle[0] != old_angle) {
+
+        mark_item_changed(physics_states, 0);
+    }
 
     if (input_state->shoot &&
         weapon_states->firing_state[curr_weapon] < 0.01) {
@@ -1057,104 +2705,426 @@ void step_player(float delta) {
                       -dir_y * BULLET_SPEED + y_speed);
 
         weapon_states->firing_state[curr_weapon] = MAX_FIRING_STATE;
+        add_timer(TIMER_WEAPON_READY, curr_weapon,
+                  get_time_ms_after(MAX_FIRING_STATE / weapon_states->firing_speed[curr_weapon]));
     }
 }
+// bullets are only queued for destruction,
+// so every bullet is visited even when some go
 void step_bullets(float delta) {
     for (table_id_t i = 0; i < bullets->curr_max; i += 1) {
-        if (bullets->used[i]) {
-            const table_id_t entity_id = bullets->entity_id[i];
-            const struct timespec created_at = bullets->created_at[i];
-            if (timespec_diff_float(&curr_time, &created_at) > BULLET_LIFETIME) {
-                destroy_bullet(entity_id);
-                break;
+        const table_id_t entity_id = bullets->entity_id[i];
+        // sweep_bullets already queued a bullet that hit,
+        // but the hit still has to land
+        // a bullet hits one enemy at most
+        table_id_t contact_start;
+        const table_id_t contact_count = find_contacts(entity_id, &contact_start);
+        bool hit = false;
+        for (table_id_t k = 0; k < contact_count && !hit; k += 1) {
+            const table_id_t entity_id_2 = collision_table->contacts[contact_start + k];
+            if (has_components(entity_id_2, COMPONENT_AI_ENEMY)) {
+                const table_id_t enemy_health_id = find_item_index(health_table, entity_id_2);
+                if (enemy_health_id < health_table->curr_max) {
+                    const float damage = bullets->damage[i];
+                    health_table->health_points[enemy_health_id] -= damage;
+                    mark_item_changed(health_table, enemy_health_id);
+                }
+                add_hit_feedback_item(entity_id_2, 100);
+                queue_command(COMMAND_DESTROY_BULLET, entity_id);
+                hit = true;
             }
-            const table_id_t collision_id = find_item_index(collision_table, entity_id);
-            if (collision_id < collision_table->curr_max) {
-                const table_id_t entity_id_2 = collision_table->entity_id_2[collision_id];
-                const table_id_t ai_enemy_id = find_item_index(ai_enemy, entity_id_2);
-                if (ai_enemy_id < ai_enemy->curr_max) {
-                    const table_id_t enemy_health_id = find_item_index(health_table, entity_id_2);
-                    if (enemy_health_id < health_table->curr_max) {
-                        const float damage = bullets->damage[i];
-                        health_table->health_points[enemy_health_id] -= damage;
+        }
+        // includes bullets whose lifetime ran out
+        if (hit || has_components(entity_id, COMPONENT_DYING)) {
+            continue;
+        }
+        const table_id_t physics_id = find_item_index(physics_states, entity_id);
+        const float x = physics_states->x[physics_id];
+        const float y = physics_states->y[physics_id];
+        if (x < 0 || x > screen_width ||
+            y < 0 || y > screen_height) {
+
+            queue_command(COMMAND_DESTROY_BULLET, entity_id);
+        }
+    }
+}
+
+// earliest t in [0, 1] at which a circle at (x, y) moving by (move_x, move_y)
+// touches a circle at the origin, radius is the sum of their radiuses
+// returns more than 1 if they don't touch
+float get_time_of_impact(float x, float y, float move_x, float move_y, float radius) {
+    const float c = x*x + y*y - radius*radius;
+    // already touching
+    if (c <= 0) {
+        return 0;
+    }
+    const float a = move_x*move_x + move_y*move_y;
+    const float b = x*move_x + y*move_y;
+    // not moving, or moving apart
+    if (a == 0 || b >= 0) {
+        return 2;
+    }
+    const float discriminant = b*b - a*c;
+    if (discriminant < 0) {
+        return 2;
+    }
+    return (-b - sqrtf(discriminant)) / a;
+}
+// bullets are too fast and too small for the overlap test,
+// so they're tested against enemies along their whole move
+// motion is relative, so enemies moving into a bullet count too
+// enemies move much less than a cell per step,
+// so the ring of cells around the bullet's path is enough
+void sweep_bullets(float delta) {
+    struct Physics_Grid* grid = physics_grid;
+    for (table_id_t i = 0; i < physics_balls->curr_max; i += 1) {
+        const table_id_t entity_id = physics_balls->entity_id[i];
+        if (grid->physics_id[i] >= physics_states->curr_max || grid->spent[i] ||
+            !has_components(entity_id, COMPONENT_BULLET)) {
+
+            continue;
+        }
+        const table_id_t physics_id = grid->physics_id[i];
+        const float x = physics_states->x[physics_id];
+        const float y = physics_states->y[physics_id];
+        const float move_x = physics_states->x_speed[physics_id] * delta;
+        const float move_y = physics_states->y_speed[physics_id] * delta;
+        const float radius = physics_balls->radius[i];
+
+        int min_cell_x = (int)floorf(fminf(x, x + move_x) / grid->cell_size) - 1;
+        int min_cell_y = (int)floorf(fminf(y, y + move_y) / grid->cell_size) - 1;
+        int max_cell_x = (int)floorf(fmaxf(x, x + move_x) / grid->cell_size) + 1;
+        int max_cell_y = (int)floorf(fmaxf(y, y + move_y) / grid->cell_size) + 1;
+        // a long frame can move a bullet further than we look
+        if (max_cell_x - min_cell_x > MAX_SWEEP_CELLS) {
+            max_cell_x = min_cell_x + MAX_SWEEP_CELLS;
+        }
+        if (max_cell_y - min_cell_y > MAX_SWEEP_CELLS) {
+            max_cell_y = min_cell_y + MAX_SWEEP_CELLS;
+        }
+
+        float first_hit = 2;
+        table_id_t hit = physics_balls->curr_max;
+        for (int cell_y = min_cell_y; cell_y <= max_cell_y; cell_y += 1) {
+            for (int cell_x = min_cell_x; cell_x <= max_cell_x; cell_x += 1) {
+                const table_id_t bucket = get_grid_bucket(cell_x, cell_y);
+                for (table_id_t k = grid->bucket_start[bucket]; k < grid->bucket_start[bucket + 1]; k += 1) {
+                    const table_id_t j = grid->bucket_items[k];
+                    // other cells can hash to the same bucket
+                    if (grid->cell_x[j] != cell_x || grid->cell_y[j] != cell_y ||
+                        grid->spent[j] ||
+                        !has_components(physics_balls->entity_id[j], COMPONENT_AI_ENEMY)) {
+
+                        continue;
+                    }
+                    const table_id_t j_physics_id = grid->physics_id[j];
+                    const float t = get_time_of_impact(x - physics_states->x[j_physics_id],
+                                                       y - physics_states->y[j_physics_id],
+                                                       move_x - physics_states->x_speed[j_physics_id] * delta,
+                                                       move_y - physics_states->y_speed[j_physics_id] * delta,
+                                                       radius + physics_balls->radius[j]);
+                    if (t < first_hit) {
+                        first_hit = t;
+                        hit = j;
                     }
-                    add_hit_feedback_item(entity_id_2, 100);
-                    destroy_bullet(entity_id);
-                    break;
                 }
             }
-            const table_id_t physics_id = find_item_index(physics_states, entity_id);
+        }
+        if (first_hit > 1) {
+            continue;
+        }
+        const table_id_t hit_entity_id = physics_balls->entity_id[hit];
+        const table_id_t hit_physics_id = grid->physics_id[hit];
+        // enemy knockback, moving it now would leave it in the wrong cell
+        grid->knockback_x[hit] -= physics_states->x_speed[hit_physics_id] * delta * 10;
+        grid->knockback_y[hit] -= physics_states->y_speed[hit_physics_id] * delta * 10;
+        add_collision_item(entity_id, hit_entity_id);
+        // step_bullets lands the hit
+        // this bullet can't hurt anyone else
+        grid->spent[i] = true;
+        queue_command(COMMAND_DESTROY_BULLET, entity_id);
+    }
+}
+
+// the overlap test can run on several threads (build with SHOOTER_THREADS),
+// each worker takes a range of bucket_items, so a share of the grid cells
+// workers only write the push of their own balls,
+// and keep the contacts they find to themselves,
+// the main thread merges them in worker order,
+// so the result is the same for any number of threads
+#ifdef SHOOTER_THREADS
+#define MAX_PHYSICS_THREADS 16
+// the threads of a pool wait at its gate until all of them are started,
+// so if one can't be, the others can be sent home
+// instead of waiting at a barrier for a thread that doesn't exist
+enum Thread_Gate_State {
+    GATE_CLOSED,
+    GATE_OPEN,
+    GATE_GIVEN_UP,
+};
+struct Thread_Gate {
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+    enum Thread_Gate_State state;
+};
+#define THREAD_GATE_INIT {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, GATE_CLOSED}
+// false if the pool was given up
+bool pass_thread_gate(struct Thread_Gate* gate) {
+    pthread_mutex_lock(&gate->lock);
+    while (gate->state == GATE_CLOSED) {
+        pthread_cond_wait(&gate->changed, &gate->lock);
+    }
+    const bool open = gate->state == GATE_OPEN;
+    pthread_mutex_unlock(&gate->lock);
+    return open;
+}
+void set_thread_gate(struct Thread_Gate* gate, enum Thread_Gate_State state) {
+    pthread_mutex_lock(&gate->lock);
+    gate->state = state;
+    pthread_cond_broadcast(&gate->changed);
+    pthread_mutex_unlock(&gate->lock);
+}
+#else
+#define MAX_PHYSICS_THREADS 1
+#endif
+// fewer balls than this per thread aren't worth waking the threads for
+#define MIN_BALLS_PER_PHYSICS_THREAD 256
+struct Physics_Worker {
+    // bucket_items[start..end] are this worker's balls
+    table_id_t start;
+    table_id_t end;
+    // entity pairs, two ids per contact
+    // grown by the worker with realloc, the arena can't move while it runs
+    table_id_t* contacts;
+    size_t contact_count;
+    size_t contact_max;
+#ifdef SHOOTER_THREADS
+    pthread_t thread;
+#endif
+};
+struct Physics_Workers {
+    // including the main thread, which is worker 0
+    uint count;
+    struct Physics_Worker workers[MAX_PHYSICS_THREADS];
+#ifdef SHOOTER_THREADS
+    // every tick, the threads wait at start until the work is set up,
+    // and at done until all of it is finished
+    pthread_barrier_t start;
+    pthread_barrier_t done;
+    bool quit;
+    struct Thread_Gate gate;
+#endif
+};
+struct Physics_Workers physics_workers = {
+    .count = 1,
+#ifdef SHOOTER_THREADS
+    .gate = THREAD_GATE_INIT,
+#endif
+};
+
+// without the memory to grow, the contact is dropped, the balls are still pushed apart
+void add_worker_contact(struct Physics_Worker* worker, table_id_t entity_id, table_id_t entity_id_2) {
+    if (worker->contact_count == worker->contact_max) {
+        const size_t contact_max = worker->contact_max ? worker->contact_max * 2 : 256;
+        table_id_t* contacts = realloc(worker->contacts, contact_max * 2 * sizeof(table_id_t));
+        if (contacts == NULL) {
+            return;
+        }
+        worker->contacts = contacts;
+        worker->contact_max = contact_max;
+    }
+    worker->contacts[worker->contact_count * 2] = entity_id;
+    worker->contacts[worker->contact_count * 2 + 1] = entity_id_2;
+    worker->contact_count += 1;
+}
+// a ball's push is from both sides of each of its pairs,
+// what its own visit of the pair pushes it and what the other ball's visit does,
+// so no ball writes to another
+// only the lower ball of a pair records it
+void collide_physics_balls(struct Physics_Worker* worker) {
+    struct Physics_Grid* grid = physics_grid;
+    worker->contact_count = 0;
+    for (table_id_t k = worker->start; k < worker->end; k += 1) {
+        const table_id_t i = grid->bucket_items[k];
+        float push_x = 0;
+        float push_y = 0;
+        if (!grid->spent[i]) {
+            const table_id_t entity_id = physics_balls->entity_id[i];
+            const table_id_t physics_id = grid->physics_id[i];
+            const bool is_bullet = has_components(entity_id, COMPONENT_BULLET);
+            const bool is_enemy = has_components(entity_id, COMPONENT_AI_ENEMY);
             const float x = physics_states->x[physics_id];
             const float y = physics_states->y[physics_id];
-            if (x < 0 || x > screen_width ||
-                y < 0 || y > screen_height) {
+            const float radius = physics_balls->radius[i];
+            const float mass = physics_balls->mass[i];
+            for (int cell_y = grid->cell_y[i] - 1; cell_y <= grid->cell_y[i] + 1; cell_y += 1) {
+                for (int cell_x = grid->cell_x[i] - 1; cell_x <= grid->cell_x[i] + 1; cell_x += 1) {
+                    const table_id_t bucket = get_grid_bucket(cell_x, cell_y);
+                    for (table_id_t l = grid->bucket_start[bucket]; l < grid->bucket_start[bucket + 1]; l += 1) {
+                        const table_id_t j = grid->bucket_items[l];
+                        // other cells can hash to the same bucket
+                        if (grid->cell_x[j] != cell_x || grid->cell_y[j] != cell_y) {
+                            continue;
+                        }
+                        // dying balls are out of the simulation
+                        if (j == i || grid->spent[j]) {
+                            continue;
+                        }
+                        const table_id_t j_entity_id = physics_balls->entity_id[j];
+                        const bool j_is_bullet = has_components(j_entity_id, COMPONENT_BULLET);
+                        const bool j_is_enemy = has_components(j_entity_id, COMPONENT_AI_ENEMY);
+                        // sweep_bullets already did these
+                        if ((is_enemy && j_is_bullet) || (is_bullet && j_is_enemy)) {
+                            continue;
+                        }
+                        const table_id_t j_physics_id = grid->physics_id[j];
+                        const float j_x = physics_states->x[j_physics_id];
+                        const float j_y = physics_states->y[j_physics_id];
+                        const float j_radius = physics_balls->radius[j];
 
-                destroy_bullet(entity_id);
-                break;
+                        float dx, dy, distance;
+                        get_distance_to_point(x, y, j_x, j_y, &dx, &dy, &distance);
+
+                        if (distance < radius + j_radius) {
+                            // our visit pushes by (dx / 2 + dir * radius) * power,
+                            // the other ball's visit by (dx / 2 + dir * j_radius) * power
+                            const float dir_x = dx / distance;
+                            const float dir_y = dy / distance;
+                            const float power = (radius + j_radius - distance);
+                            push_x -= (dx + dir_x * (radius + j_radius)) * power / mass;
+                            push_y -= (dy + dir_y * (radius + j_radius)) * power / mass;
+                            if (i < j) {
+                                add_worker_contact(worker, entity_id, j_entity_id);
+                            }
+                        }
+                    }
+                }
             }
         }
+        grid->push_x[i] = push_x;
+        grid->push_y[i] = push_y;
+    }
+}
+
+#ifdef SHOOTER_THREADS
+void* run_physics_worker(void* worker) {
+    if (!pass_thread_gate(&physics_workers.gate)) {
+        return NULL;
+    }
+    while (true) {
+        pthread_barrier_wait(&physics_workers.start);
+        if (physics_workers.quit) {
+            return NULL;
+        }
+        collide_physics_balls(worker);
+        pthread_barrier_wait(&physics_workers.done);
+    }
+}
+#endif
+// 0 picks one per core
+// without SHOOTER_THREADS, or if the threads can't be started,
+// there's only the main thread
+EMSCRIPTEN_KEEPALIVE
+void set_physics_thread_count(uint count) {
+#ifdef SHOOTER_THREADS
+    if (count == 0) {
+        const long core_count = sysconf(_SC_NPROCESSORS_ONLN);
+        count = core_count > 0 ? core_count : 1;
+    }
+    if (count > MAX_PHYSICS_THREADS) {
+        count = MAX_PHYSICS_THREADS;
+    }
+    struct Physics_Workers* workers = &physics_workers;
+    if (workers->count > 1) {
+        workers->quit = true;
+        pthread_barrier_wait(&workers->start);
+        for (uint w = 1; w < workers->count; w += 1) {
+            pthread_join(workers->workers[w].thread, NULL);
+        }
+        pthread_barrier_destroy(&workers->start);
+        pthread_barrier_destroy(&workers->done);
+    }
+    workers->quit = false;
+    workers->count = 1;
+    if (count <= 1) {
+        return;
+    }
+    if (pthread_barrier_init(&workers->start, NULL, count) != 0) {
+        return;
+    }
+    if (pthread_barrier_init(&workers->done, NULL, count) != 0) {
+        pthread_barrier_destroy(&workers->start);
+        return;
+    }
+    workers->gate.state = GATE_CLOSED;
+    uint started = 1;
+    while (started < count &&
+           pthread_create(&workers->workers[started].thread, NULL,
+                          &run_physics_worker, &workers->workers[started]) == 0) {
+        started += 1;
+    }
+    if (started < count) {
+        set_thread_gate(&workers->gate, GATE_GIVEN_UP);
+        for (uint w = 1; w < started; w += 1) {
+            pthread_join(workers->workers[w].thread, NULL);
+        }
+        pthread_barrier_destroy(&workers->start);
+        pthread_barrier_destroy(&workers->done);
+        return;
     }
+    workers->count = count;
+    set_thread_gate(&workers->gate, GATE_OPEN);
+#endif
+}
+EMSCRIPTEN_KEEPALIVE
+uint get_physics_thread_count() {
+    return physics_workers.count;
 }
 
+// the push moves overlapping balls apart by how much they overlap,
+// whatever the delta
+// only speeds change, so every iteration reads the grid step_physics built
 void step_physics_balls(float delta) {
-    const float delta_iter = delta / PHYSICS_BALL_ITER_COUNT;
+    struct Physics_Grid* grid = physics_grid;
+    struct Physics_Workers* workers = &physics_workers;
     for (size_t iter = 0; iter < PHYSICS_BALL_ITER_COUNT; iter += 1) {
-        for (table_id_t i = 0; i < physics_balls->curr_max; i += 1) {
-            if (physics_balls->used[i]) {
-                const table_id_t entity_id = physics_balls->entity_id[i];
-                const table_id_t physics_id = find_item_index(physics_states, entity_id);
-                const bool is_bullet = find_item_index(bullets, entity_id) < bullets->curr_max;
-                const bool is_enemy = find_item_index(ai_enemy, entity_id) < ai_enemy->curr_max;
-                const float x = physics_states->x[physics_id];
-                const float y = physics_states->y[physics_id];
-                const float radius = physics_balls->radius[i];
-                const float mass = physics_balls->mass[i];
-                for (table_id_t j = 0; j < physics_balls->curr_max; j += 1) {
-                    if (physics_balls->used[j]) {
-                        if (j != i) {
-                            const table_id_t j_entity_id = physics_balls->entity_id[j];
-                            const table_id_t j_physics_id = find_item_index(physics_states, j_entity_id);
-                            const bool j_is_bullet = find_item_index(bullets, j_entity_id) < bullets->curr_max;
-                            const bool j_is_enemy = find_item_index(ai_enemy, j_entity_id) < ai_enemy->curr_max;
-                            const float j_x = physics_states->x[j_physics_id];
-                            const float j_y = physics_states->y[j_physics_id];
-                            const float j_radius = physics_balls->radius[j];
-                            const float j_mass = physics_balls->mass[j];
-
-                            float dx, dy, distance;
-                            get_distance_to_point(x, y, j_x, j_y, &dx, &dy, &distance);
-
-                            if (distance < radius + j_radius) {
-                                    
-                                if (is_enemy && j_is_bullet) {
-                                    // enemy knockback
-                                    physics_states->x[i] -= physics_states->x_speed[i] * delta * 10;
-                                    physics_states->y[i] -= physics_states->y_speed[i] * delta * 10;
-                                    add_collision_item(j_entity_id, entity_id);
-                                    // we're gonna destroy this bullet in step_bullets
-                                    // this bullet can't hurt anyone else
-                                    remove_physics_state(j_entity_id);
-                                    remove_sprite_map(j_entity_id);
-                                    remove_physics_ball(j_entity_id);
-                                    break;
-                                }
-
-                                const float mid_x = dx / 2;
-                                const float mid_y = dy / 2;
-                                const float dir_x = dx / distance;
-                                const float dir_y = dy / distance;
-                                const float power = (radius + j_radius - distance);
-                                float push_x = (mid_x + dir_x * radius) * power;
-                                float push_y = (mid_y + dir_y * radius) * power;
-                                physics_states->x_speed[physics_id] -= push_x / mass;
-                                physics_states->y_speed[physics_id] -= push_y / mass;
-                                physics_states->x_speed[j_physics_id] += push_x / j_mass;
-                                physics_states->y_speed[j_physics_id] += push_y / j_mass;
-                                add_collision_item(entity_id, j_entity_id);
-                            }
-                        }
-                    }
-                }
+        const table_id_t ball_count = grid->bucket_start[grid->bucket_count];
+        uint worker_count = 1;
+        if (ball_count >= MIN_BALLS_PER_PHYSICS_THREAD * 2) {
+            worker_count = workers->count;
+        }
+        for (uint w = 0; w < workers->count; w += 1) {
+            // the threads we don't need get nothing to do
+            const uint share = w < worker_count ? w : worker_count;
+            workers->workers[w].start = (size_t)ball_count * share / worker_count;
+            workers->workers[w].end = w < worker_count ? (size_t)ball_count * (share + 1) / worker_count
+                                                       : ball_count;
+        }
+#ifdef SHOOTER_THREADS
+        if (worker_count > 1) {
+            pthread_barrier_wait(&workers->start);
+            collide_physics_balls(&workers->workers[0]);
+            pthread_barrier_wait(&workers->done);
+        }
+        else
+#endif
+        {
+            collide_physics_balls(&workers->workers[0]);
+        }
+
+        for (uint w = 0; w < worker_count; w += 1) {
+            const struct Physics_Worker* worker = &workers->workers[w];
+            for (size_t c = 0; c < worker->contact_count; c += 1) {
+                add_collision_item(worker->contacts[c * 2], worker->contacts[c * 2 + 1]);
+            }
+        }
+        for (table_id_t k = 0; k < ball_count; k += 1) {
+            const table_id_t i = grid->bucket_items[k];
+            const table_id_t physics_id = grid->physics_id[i];
+            physics_states->x_speed[physics_id] += grid->push_x[i];
+            physics_states->y_speed[physics_id] += grid->push_y[i];
+            if (grid->push_x[i] != 0 || grid->push_y[i] != 0) {
+                mark_item_changed(physics_states, physics_id);
             }
         }
     }
@@ -1163,39 +3133,58 @@ void step_physics_balls(float delta) {
 void step_physics(float delta) {
     const float delta_iter = delta / PHYSICS_ITER_COUNT;
     for (size_t iter = 0; iter < PHYSICS_ITER_COUNT; iter += 1) {
+        // once per step, nothing moves until the speeds are integrated
+        build_physics_grid();
+        sweep_bullets(delta_iter);
         step_physics_balls(delta_iter);
-        for (table_id_t i = 0; i < physics_states->curr_max; i += 1) {
-            if (physics_states->used[i]) {
-                // when the player is dead, it can't be moved
-                if (!(i == 0 && health_table->health_points[0] < 0)) {
-                    physics_states->x[i] += physics_states->x_speed[i] * delta_iter;
-                    physics_states->y[i] += physics_states->y_speed[i] * delta_iter;
-                }
+        struct Physics_Grid* grid = physics_grid;
+        for (table_id_t i = 0; i < physics_balls->curr_max; i += 1) {
+            if (grid->knockback_x[i] != 0 || grid->knockback_y[i] != 0) {
+                const table_id_t physics_id = grid->physics_id[i];
+                physics_states->x[physics_id] += grid->knockback_x[i];
+                physics_states->y[physics_id] += grid->knockback_y[i];
+                mark_item_changed(physics_states, physics_id);
             }
         }
+        // when the player is dead, it can't be moved
+        const table_id_t first = health_table->health_points[0] < 0 ? 1 : 0;
+        if (physics_states->curr_max > first) {
+            const size_t count = physics_states->curr_max - first;
+            simd_integrate(&physics_states->x[first], &physics_states->x_speed[first], delta_iter, count);
+            simd_integrate(&physics_states->y[first], &physics_states->y_speed[first], delta_iter, count);
+        }
+    }
+    const table_id_t first = health_table->health_points[0] < 0 ? 1 : 0;
+    for (table_id_t i = first; i < physics_states->curr_max; i += 1) {
+        if (physics_states->x_speed[i] != 0 || physics_states->y_speed[i] != 0) {
+            mark_item_changed(physics_states, i);
+        }
     }
+    finish_collision_table();
 }
 
 void step_collision_resolve(float delta) {
-    for (table_id_t i = 0; i < collision_table->curr_max; i += 1) {
-        const table_id_t entity_id = collision_table->entity_id[i];
-        const table_id_t entity_id_2 = collision_table->entity_id_2[i];
-        const bool is_enemy = find_item_index(ai_enemy, entity_id) < ai_enemy->curr_max;
-        const bool with_player = entity_id_2 == 0;
-        if (is_enemy && with_player) {
+    // enemies touching the player
+    table_id_t contact_start;
+    const table_id_t contact_count = find_contacts(0, &contact_start);
+    for (table_id_t k = 0; k < contact_count; k += 1) {
+        const table_id_t entity_id = collision_table->contacts[contact_start + k];
+        if (has_components(entity_id, COMPONENT_AI_ENEMY)) {
             const table_id_t proximity_attack_id = find_item_index(proximity_attack, entity_id);
             const float proximity_attack_state = proximity_attack->attack_state[proximity_attack_id];
-            if (proximity_attack_state < 0) {
+            if (proximity_attack_state <= 0) {
                 // a zombie attacks the player
                 // should we knockback the player?
                 add_hit_feedback_item(0, 100);
-                // end bite
-                const table_id_t sprite_map_id = find_item_index(sprite_map, entity_id);
-                sprite_map->sprite_variant[sprite_map_id] = 0;
                 const float proximity_attack_damage = proximity_attack->damage[proximity_attack_id];
                 proximity_attack->attack_state[proximity_attack_id] = 100;
+                mark_item_changed(proximity_attack, proximity_attack_id);
+                schedule_proximity_attack(entity_id, 100);
+                // end bite
+                refresh_sprite_variant(entity_id);
                 if (health_table->health_points[0] >= 0) {
                     health_table->health_points[0] -= proximity_attack_damage;
+                    mark_item_changed(health_table, 0);
                 }
             }
         }
@@ -1203,88 +3192,149 @@ void step_collision_resolve(float delta) {
 }
 
 void step_ai_enemy(float delta) {
-    const float delta_iter =  delta / AI_ENEMY_ITER_COUNT;
+    // every enemy that died this tick, counted once,
+    // they stay in the tables until the commands are flushed
+    for (table_id_t i = 0; i < ai_enemy->curr_max; i += 1) {
+        const table_id_t entity_id = ai_enemy->entity_id[i];
+        const enemy_type_t enemy_type = ai_enemy->enemy_type[i];
+        const table_id_t health_id = find_cached_item_index(health_table, entity_id, ai_enemy, i, &ai_enemy->health_id[i]);
+        const float health_points = health_table->health_points[health_id];
+        if (health_points < 0.1) {
+            if (enemy_type == ENEMY_PLAIN &&
+                queue_command(COMMAND_DESTROY_ZOMBIE, entity_id)) {
+
+                score += 200 * curr_wave;
+                wave_completion.remaining[enemy_type] -= 1;
+            }
+        }
+    }
+
     const float player_x = physics_states->x[0];
     const float player_y = physics_states->y[0];
+    build_ai_field(player_x, player_y);
+
+    // keep away from other enemies, by moving to where the crowd is thinner
+    const float delta_iter =  delta / AI_ENEMY_ITER_COUNT;
     for (size_t iter = 0; iter < AI_ENEMY_ITER_COUNT; iter += 1) {
+        build_ai_density();
         for (table_id_t i = 0; i < ai_enemy->curr_max; i += 1) {
-            if (ai_enemy->used[i]) {
-                const table_id_t entity_id = ai_enemy->entity_id[i];
-                const enemy_type_t enemy_type = ai_enemy->enemy_type[i];
-                const table_id_t health_id = find_item_index(health_table, entity_id);
-                const float health_points = health_table->health_points[health_id];
-                if (health_points < 0.1) {
-                    if (enemy_type == ENEMY_PLAIN) {
-                        destroy_zombie(entity_id);
-                        score += 200 * curr_wave;
-                    }
-                    wave_completion.remaining[enemy_type] -= 1;
-                    break;
-                }
-                const table_id_t physics_id = find_item_index(physics_states, entity_id);
-                const float x = physics_states->x[physics_id];
-                const float y = physics_states->y[physics_id];
-                float player_dx, player_dy, player_distance, player_dir_x, player_dir_y, player_angle;
-                get_angle_to_point(player_x, player_y, x, y,
-                                &player_dx, &player_dy, &player_distance,
-                                &player_dir_x, &player_dir_y, &player_angle);
-
-                physics_states->x_speed[physics_id] = -player_dir_x * ZOMBIE_SPEED * fabs(sin(timespec_to_float(&curr_time) * 5));
-                physics_states->y_speed[physics_id] = -player_dir_y * ZOMBIE_SPEED * fabs(sin(timespec_to_float(&curr_time) * 5));
-                physics_states->angle[physics_id] = player_angle;
-
-                // keep away from other enemies
-                for (table_id_t j = 0; j < ai_enemy->curr_max; j += 1) {
-                    if (j != i && ai_enemy->used[j]) {
-                        const table_id_t j_entity_id = ai_enemy->entity_id[j];
-                        const table_id_t j_physics_id = find_item_index(physics_states, j_entity_id);
-                        const float j_x = physics_states->x[j_physics_id];
-                        const float j_y = physics_states->y[j_physics_id];
-                        float dx, dy, distance;
-                        get_distance_to_point(x, y, j_x, j_y, &dx, &dy, &distance);
-                        const float distance_diff = distance - AI_ENEMY_PREFERRED_DISTANCE;
-                        if (distance_diff < 0) {
-                            physics_states->x[physics_id] += distance_diff * dx * delta_iter;
-                            physics_states->y[physics_id] += distance_diff * dy * delta_iter;
-                        }
-                    }
-                }
+            if (has_components(ai_enemy->entity_id[i], COMPONENT_DYING)) {
+                continue;
+            }
+            const table_id_t physics_id = ai_enemy->physics_id[i];
+            float gradient_x, gradient_y;
+            sample_ai_field_gradient(ai_field->density,
+                                     physics_states->x[physics_id], physics_states->y[physics_id],
+                                     &gradient_x, &gradient_y);
+            physics_states->x[physics_id] -= gradient_x * AI_ENEMY_SEPARATION_SPEED * delta_iter;
+            physics_states->y[physics_id] -= gradient_y * AI_ENEMY_SEPARATION_SPEED * delta_iter;
+            if (gradient_x != 0 || gradient_y != 0) {
+                mark_item_changed(physics_states, physics_id);
             }
         }
     }
+
+    // chase the player, straight at it
+    const float speed = ZOMBIE_SPEED * fabs(sin(timespec_to_float(&curr_time) * 5));
+    for (table_id_t i = 0; i < ai_enemy->curr_max; i += 1) {
+        const table_id_t physics_id = ai_enemy->physics_id[i];
+        const float dx = player_x - physics_states->x[physics_id];
+        const float dy = player_y - physics_states->y[physics_id];
+        const float length = sqrtf(dx*dx + dy*dy);
+        const float dir_x = length > 0 ? dx / length : 0;
+        const float dir_y = length > 0 ? dy / length : 0;
+        physics_states->x_speed[physics_id] = dir_x * speed;
+        physics_states->y_speed[physics_id] = dir_y * speed;
+        physics_states->angle[physics_id] = atan2f(-dir_y, -dir_x);
+        mark_item_changed(physics_states, physics_id);
+    }
 }
 
-void step_proximity_attack(float delta) {
-    for (table_id_t i = 0; i < proximity_attack->curr_max; i += 1) {
-        if (proximity_attack->used[i]) {
-            if (proximity_attack->attack_state[i] > 0) {
-                proximity_attack->attack_state[i] -= 100 * delta;
-            }
-            if (proximity_attack->attack_state[i] < 20) {
-                // prepare to bite
-                const table_id_t entity_id = proximity_attack->entity_id[i];
-                const table_id_t sprite_map_id = find_item_index(sprite_map, entity_id);
-                sprite_map->sprite_variant[sprite_map_id] = 2;
-            }
+void step_timers() {
+    advance_timer_wheel(get_time_ms());
+}
+// the systems below handle the timers step_timers fired, each its own type,
+// so they can run side by side
+void step_bullet_lifetime_timers() {
+    const struct Timer_Wheel* wheel = timer_wheel;
+    for (size_t f = 0; f < wheel->fired_count; f += 1) {
+        const table_id_t entity_id = wheel->fired_id[f];
+        if (wheel->fired_type[f] == TIMER_BULLET_LIFETIME &&
+            has_components(entity_id, COMPONENT_BULLET)) {
+
+            queue_command(COMMAND_DESTROY_BULLET, entity_id);
         }
     }
 }
-
-void step_hit_feedback_table(float delta) {
-    for (table_id_t i = 0; i < hit_feedback_table->curr_max; i += 1) {
-        hit_feedback_table->amount[i] -= HIT_FEEDBACK_SPEED * delta;
-        const table_id_t entity_id = hit_feedback_table->entity_id[i];
-        const table_id_t sprite_map_id = find_item_index(sprite_map, entity_id);
-        if (hit_feedback_table->amount[i] < 0) {
-            remove_table_item(hit_feedback_table, hit_feedback_table->entity_id[i]);
-            const table_id_t health_id = find_item_index(sprite_map, entity_id);
-            const float health_points = health_table->health_points[health_id];
-            if (health_points > 0) {
-                sprite_map->sprite_variant[sprite_map_id] = 0;
-            }
+void step_proximity_attack_timers() {
+    const struct Timer_Wheel* wheel = timer_wheel;
+    for (size_t f = 0; f < wheel->fired_count; f += 1) {
+        const enum Timer_Type type = wheel->fired_type[f];
+        if (type != TIMER_PROXIMITY_PREPARE && type != TIMER_PROXIMITY_READY) {
+            continue;
+        }
+        const table_id_t entity_id = wheel->fired_id[f];
+        const table_id_t proximity_attack_id = find_item_index(proximity_attack, entity_id);
+        if (proximity_attack_id == proximity_attack->curr_max) {
+            continue;
+        }
+        if (type == TIMER_PROXIMITY_PREPARE) {
+            // prepare to bite
+            proximity_attack->attack_state[proximity_attack_id] = PROXIMITY_ATTACK_PREPARE;
+            schedule_proximity_attack(entity_id, PROXIMITY_ATTACK_PREPARE);
         }
         else {
-            sprite_map->sprite_variant[sprite_map_id] = 1;
+            proximity_attack->attack_state[proximity_attack_id] = 0;
+        }
+        mark_item_changed(proximity_attack, proximity_attack_id);
+    }
+}
+void step_hit_feedback_timers() {
+    const struct Timer_Wheel* wheel = timer_wheel;
+    for (size_t f = 0; f < wheel->fired_count; f += 1) {
+        if (wheel->fired_type[f] != TIMER_HIT_FEEDBACK) {
+            continue;
+        }
+        const table_id_t entity_id = wheel->fired_id[f];
+        const table_id_t hit_feedback_id = find_item_index(hit_feedback_table, entity_id);
+        // hit again since
+        if (hit_feedback_id == hit_feedback_table->curr_max ||
+            hit_feedback_table->expire_at[hit_feedback_id] != wheel->fired_expire_at[f]) {
+
+            continue;
+        }
+        remove_hit_feedback_item(entity_id);
+    }
+}
+void step_weapon_timers() {
+    const struct Timer_Wheel* wheel = timer_wheel;
+    for (size_t f = 0; f < wheel->fired_count; f += 1) {
+        const table_id_t weapon = wheel->fired_id[f];
+        if (wheel->fired_type[f] == TIMER_WEAPON_READY &&
+            weapon < weapon_states->max_count) {
+
+            weapon_states->firing_state[weapon] = 0;
+        }
+    }
+}
+// after the proximity attack and hit feedback timers,
+// for the entities they may have changed
+// the dead keep their hit sprite
+void step_sprite_variants() {
+    const struct Timer_Wheel* wheel = timer_wheel;
+    for (size_t f = 0; f < wheel->fired_count; f += 1) {
+        const enum Timer_Type type = wheel->fired_type[f];
+        if (type != TIMER_PROXIMITY_PREPARE && type != TIMER_PROXIMITY_READY &&
+            type != TIMER_HIT_FEEDBACK) {
+
+            continue;
+        }
+        const table_id_t entity_id = wheel->fired_id[f];
+        const table_id_t health_id = find_item_index(health_table, entity_id);
+        if (health_id < health_table->curr_max &&
+            health_table->health_points[health_id] > 0) {
+
+            refresh_sprite_variant(entity_id);
         }
     }
 }
@@ -1310,26 +3360,1753 @@ void step_overlay_data(float delta) {
     }
 }
 
+// in the order tick runs them
+enum Systems {
+    SYSTEM_TIMERS,
+    SYSTEM_SAVE_PREV_PHYSICS,
+    SYSTEM_CLEAR_COLLISIONS,
+    SYSTEM_PHYSICS,
+    SYSTEM_COLLISION_RESOLVE,
+    SYSTEM_BULLET_LIFETIME_TIMERS,
+    SYSTEM_PROXIMITY_ATTACK_TIMERS,
+    SYSTEM_HIT_FEEDBACK_TIMERS,
+    SYSTEM_WEAPON_TIMERS,
+    SYSTEM_WAVE_REST,
+    SYSTEM_SPRITE_VARIANTS,
+    SYSTEM_PLAYER,
+    SYSTEM_AI_ENEMY,
+    SYSTEM_BULLETS,
+    SYSTEM_FLUSH_COMMANDS,
+    SYSTEM_WAVE_EMITTER,
+    SYSTEM_WAVE_COMPLETION,
+    SYSTEM_OVERLAY_DATA,
+    SYSTEM_COUNT,
+};
+const char* system_names[SYSTEM_COUNT] = {
+    "timers",
+    "save_prev_physics",
+    "clear_collisions",
+    "physics",
+    "collision_resolve",
+    "bullet_lifetime",
+    "proximity_attack",
+    "hit_feedback",
+    "weapon_timers",
+    "wave_rest",
+    "sprite_variants",
+    "player",
+    "ai_enemy",
+    "bullets",
+    "flush_commands",
+    "wave_emitter",
+    "wave_completion",
+    "overlay_data",
+};
+struct Timer_Queue timer_queues[SYSTEM_COUNT];
+void run_system(enum Systems system, float delta) {
+    timer_queue = &timer_queues[system];
+    switch (system) {
+        case SYSTEM_TIMERS:            step_timers(); break;
+        case SYSTEM_SAVE_PREV_PHYSICS: save_prev_physics_states(); break;
+        case SYSTEM_CLEAR_COLLISIONS:  clear_collision_table(); break;
+        case SYSTEM_PHYSICS:           step_physics(delta); break;
+        case SYSTEM_COLLISION_RESOLVE: step_collision_resolve(delta); break;
+        case SYSTEM_BULLET_LIFETIME_TIMERS:  step_bullet_lifetime_timers(); break;
+        case SYSTEM_PROXIMITY_ATTACK_TIMERS: step_proximity_attack_timers(); break;
+        case SYSTEM_HIT_FEEDBACK_TIMERS:     step_hit_feedback_timers(); break;
+        case SYSTEM_WEAPON_TIMERS:     step_weapon_timers(); break;
+        case SYSTEM_SPRITE_VARIANTS:   step_sprite_variants(); break;
+        case SYSTEM_PLAYER:            step_player(delta); break;
+        case SYSTEM_AI_ENEMY:          step_ai_enemy(delta); break;
+        case SYSTEM_BULLETS:           step_bullets(delta); break;
+        case SYSTEM_FLUSH_COMMANDS:    flush_commands(); break;
+        case SYSTEM_WAVE_EMITTER:      step_wave_emitter(); break;
+        case SYSTEM_WAVE_REST:         step_wave_rest(delta); break;
+        case SYSTEM_WAVE_COMPLETION:
+            if (wave_rest.rest_state < 0) {
+                step_wave_completion();
+            }
+            break;
+        case SYSTEM_OVERLAY_DATA:      step_overlay_data(delta); break;
+        case SYSTEM_COUNT: break;
+    }
+    timer_queue = NULL;
+}
+
+// what each system touches, so tick knows which ones can run side by side
+// ARENA is the layout of the tables, every system reads it,
+// tick makes room for the items the other systems add before they run,
+// see `reserve_tick_capacity`, so only physics,
+// whose collision table grows, writes ARENA and runs alone
+// the timers systems add are queued, see `struct Timer_Queue`,
+// so adding one doesn't touch TIMERS
+enum Resources {
+    RESOURCE_ARENA       = 1<<0,
+    // the entity slots, which entities are alive
+    // each component bit belongs to its table's resource, COMPONENT_DYING to COMMANDS
+    RESOURCE_ENTITIES    = 1<<1,
+    // physics_states, physics_balls and the grid
+    RESOURCE_PHYSICS     = 1<<2,
+    RESOURCE_COLLISIONS  = 1<<3,
+    // the wheel
+    RESOURCE_TIMERS      = 1<<4,
+    // the timers the wheel fired this tick
+    RESOURCE_FIRED       = 1<<5,
+    RESOURCE_COMMANDS    = 1<<6,
+    RESOURCE_HEALTH      = 1<<7,
+    RESOURCE_PROXIMITY   = 1<<8,
+    RESOURCE_HIT_FEEDBACK = 1<<9,
+    RESOURCE_SPRITES     = 1<<10,
+    RESOURCE_WEAPONS     = 1<<11,
+    // ai_enemy, its cached row indices and ai_field
+    RESOURCE_AI          = 1<<12,
+    RESOURCE_BULLETS     = 1<<13,
+    // the campaign, the wave structs, curr_wave and score
+    RESOURCE_WAVES       = 1<<14,
+    RESOURCE_OVERLAY     = 1<<15,
+    RESOURCE_INPUT       = 1<<16,
+    // randf
+    RESOURCE_RANDOM      = 1<<17,
+};
+typedef uint resource_mask_t;
+struct System_Access {
+    resource_mask_t reads;
+    resource_mask_t writes;
+};
+struct System_Access system_access[SYSTEM_COUNT] = {
+    [SYSTEM_TIMERS] = {
+        .reads  = RESOURCE_ARENA,
+        .writes = RESOURCE_TIMERS | RESOURCE_FIRED,
+    },
+    [SYSTEM_SAVE_PREV_PHYSICS] = {
+        .reads  = RESOURCE_ARENA,
+        .writes = RESOURCE_PHYSICS,
+    },
+    [SYSTEM_CLEAR_COLLISIONS] = {
+        .reads  = RESOURCE_ARENA,
+        .writes = RESOURCE_COLLISIONS,
+    },
+    // the collision table grows
+    [SYSTEM_PHYSICS] = {
+        .reads  = RESOURCE_ENTITIES | RESOURCE_HEALTH | RESOURCE_AI | RESOURCE_BULLETS,
+        .writes = RESOURCE_ARENA | RESOURCE_PHYSICS | RESOURCE_COLLISIONS | RESOURCE_COMMANDS,
+    },
+    [SYSTEM_COLLISION_RESOLVE] = {
+        .reads  = RESOURCE_ARENA | RESOURCE_ENTITIES | RESOURCE_COLLISIONS | RESOURCE_AI,
+        .writes = RESOURCE_HEALTH | RESOURCE_PROXIMITY | RESOURCE_HIT_FEEDBACK | RESOURCE_SPRITES,
+    },
+    [SYSTEM_BULLET_LIFETIME_TIMERS] = {
+        .reads  = RESOURCE_ARENA | RESOURCE_ENTITIES | RESOURCE_FIRED | RESOURCE_BULLETS,
+        .writes = RESOURCE_COMMANDS,
+    },
+    [SYSTEM_PROXIMITY_ATTACK_TIMERS] = {
+        .reads  = RESOURCE_ARENA | RESOURCE_ENTITIES | RESOURCE_FIRED,
+        .writes = RESOURCE_PROXIMITY,
+    },
+    [SYSTEM_HIT_FEEDBACK_TIMERS] = {
+        .reads  = RESOURCE_ARENA | RESOURCE_ENTITIES | RESOURCE_FIRED,
+        .writes = RESOURCE_HIT_FEEDBACK,
+    },
+    [SYSTEM_WEAPON_TIMERS] = {
+        .reads  = RESOURCE_ARENA | RESOURCE_FIRED,
+        .writes = RESOURCE_WEAPONS,
+    },
+    [SYSTEM_WAVE_REST] = {
+        .reads  = RESOURCE_ARENA,
+        .writes = RESOURCE_WAVES | RESOURCE_OVERLAY,
+    },
+    [SYSTEM_SPRITE_VARIANTS] = {
+        .reads  = RESOURCE_ARENA | RESOURCE_ENTITIES | RESOURCE_FIRED | RESOURCE_HEALTH |
+                  RESOURCE_PROXIMITY | RESOURCE_HIT_FEEDBACK,
+        .writes = RESOURCE_SPRITES,
+    },
+    // creates bullets
+    [SYSTEM_PLAYER] = {
+        .reads  = RESOURCE_ARENA | RESOURCE_INPUT | RESOURCE_HEALTH,
+        .writes = RESOURCE_ENTITIES | RESOURCE_PHYSICS | RESOURCE_SPRITES | RESOURCE_BULLETS |
+                  RESOURCE_WEAPONS,
+    },
+    [SYSTEM_AI_ENEMY] = {
+        .reads  = RESOURCE_ARENA | RESOURCE_ENTITIES | RESOURCE_HEALTH,
+        .writes = RESOURCE_PHYSICS | RESOURCE_AI | RESOURCE_COMMANDS | RESOURCE_WAVES,
+    },
+    // refreshes the sprites of the enemies it hits, which looks at their proximity attack
+    [SYSTEM_BULLETS] = {
+        .reads  = RESOURCE_ARENA | RESOURCE_ENTITIES | RESOURCE_COLLISIONS | RESOURCE_PHYSICS |
+                  RESOURCE_AI | RESOURCE_BULLETS | RESOURCE_PROXIMITY,
+        .writes = RESOURCE_HEALTH | RESOURCE_HIT_FEEDBACK | RESOURCE_SPRITES | RESOURCE_COMMANDS,
+    },
+    // removes entities from every table
+    [SYSTEM_FLUSH_COMMANDS] = {
+        .reads  = RESOURCE_ARENA,
+        .writes = RESOURCE_ENTITIES | RESOURCE_COMMANDS | RESOURCE_PHYSICS | RESOURCE_SPRITES |
+                  RESOURCE_AI | RESOURCE_HEALTH | RESOURCE_PROXIMITY | RESOURCE_HIT_FEEDBACK |
+                  RESOURCE_BULLETS,
+    },
+    // creates zombies
+    [SYSTEM_WAVE_EMITTER] = {
+        .reads  = RESOURCE_ARENA,
+        .writes = RESOURCE_ENTITIES | RESOURCE_PHYSICS | RESOURCE_SPRITES | RESOURCE_AI |
+                  RESOURCE_HEALTH | RESOURCE_PROXIMITY | RESOURCE_WAVES | RESOURCE_RANDOM,
+    },
+    [SYSTEM_WAVE_COMPLETION] = {
+        .reads  = RESOURCE_ARENA,
+        .writes = RESOURCE_WAVES | RESOURCE_OVERLAY,
+    },
+    [SYSTEM_OVERLAY_DATA] = {
+        .reads  = RESOURCE_ARENA | RESOURCE_HEALTH,
+        .writes = RESOURCE_OVERLAY,
+    },
+};
+
+// system b depends on an earlier system a when one writes what the other touches
+// conflicting systems keep the order of enum Systems,
+// so a tick gives the same result however the graph is run
+// the accesses don't change, so the graph is built once
+struct System_Graph {
+    // how many earlier systems each one waits for
+    uint dependency_count[SYSTEM_COUNT];
+    uint dependent_count[SYSTEM_COUNT];
+    // dependents[a * SYSTEM_COUNT + k] is the k-th system waiting for a
+    uint dependents[SYSTEM_COUNT * SYSTEM_COUNT];
+};
+struct System_Graph system_graph;
+void build_system_graph() {
+    struct System_Graph* graph = &system_graph;
+    for (uint b = 0; b < SYSTEM_COUNT; b += 1) {
+        graph->dependency_count[b] = 0;
+        graph->dependent_count[b] = 0;
+    }
+    for (uint b = 0; b < SYSTEM_COUNT; b += 1) {
+        const struct System_Access access_b = system_access[b];
+        for (uint a = 0; a < b; a += 1) {
+            const struct System_Access access_a = system_access[a];
+            if ((access_a.writes & (access_b.reads | access_b.writes)) ||
+                (access_a.reads & access_b.writes)) {
+
+                graph->dependents[a * SYSTEM_COUNT + graph->dependent_count[a]] = b;
+                graph->dependent_count[a] += 1;
+                graph->dependency_count[b] += 1;
+            }
+        }
+    }
+}
+
 EMSCRIPTEN_KEEPALIVE
-void step() {
-    float delta = step_time();
-    clear_collision_table();
-    step_physics(delta);
-    step_collision_resolve(delta);
-    step_proximity_attack(delta);
-    step_hit_feedback_table(delta);
-    step_weapon_states(delta);
-    step_player(delta);
-    step_ai_enemy(delta);
-    step_bullets(delta);
-    step_wave_emitter();
-    step_wave_rest(delta);
-    if (wave_rest.rest_state < 0) {
-        step_wave_completion();
+const char* get_system_name(uint system) {
+    if (system >= SYSTEM_COUNT) {
+        return "";
     }
-    step_overlay_data(delta);
+    return system_names[system];
+}
+
+// per-system timings of the last PROFILE_SAMPLE_COUNT ticks,
+// one sample per tick, so a frame that catches up has several
+// times are milliseconds on the monotonic clock,
+// browsers round it to somewhere between 5us and 100us
+#define PROFILE_SAMPLE_COUNT 256
+struct Profile_Data {
+    uint enabled;
+    uint system_count;
+    uint sample_count;
+    // where the next sample goes,
+    // which is the oldest sample once the ring is full
+    uint next_sample;
+    // samples ever taken, so readers know how much of the ring is filled
+    uint total_samples;
+    double* tick_start;
+    // both are sample_count * system_count,
+    // the systems of sample s are at [s * system_count]
+    double* system_start;
+    double* system_time;
+};
+struct Profile_Data* profile_data;
+void alloc_profile_data() {
+    profile_data = malloc(sizeof(struct Profile_Data));
+    profile_data->enabled = true;
+    profile_data->system_count = SYSTEM_COUNT;
+    profile_data->sample_count = PROFILE_SAMPLE_COUNT;
+    profile_data->next_sample = 0;
+    profile_data->total_samples = 0;
+    arena_request_scratch(&profile_data->tick_start, PROFILE_SAMPLE_COUNT * sizeof(double), NULL);
+    arena_request_scratch(&profile_data->system_start, PROFILE_SAMPLE_COUNT * SYSTEM_COUNT * sizeof(double), NULL);
+    arena_request_scratch(&profile_data->system_time, PROFILE_SAMPLE_COUNT * SYSTEM_COUNT * sizeof(double), NULL);
+}
+EMSCRIPTEN_KEEPALIVE
+struct Profile_Data* get_profile_data() {
+    return profile_data;
+}
+EMSCRIPTEN_KEEPALIVE
+void set_profiling(bool enabled) {
+    profile_data->enabled = enabled;
+}
+double profile_now() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
 }
 
+#define NO_PROFILE_SAMPLE ((uint)-1)
+// a system timed on its own, for when systems run side by side
+void run_profiled_system(enum Systems system, float delta, uint sample) {
+    if (sample == NO_PROFILE_SAMPLE) {
+        run_system(system, delta);
+        return;
+    }
+    const double start = profile_now();
+    run_system(system, delta);
+    const double end = profile_now();
+    profile_data->system_start[sample * SYSTEM_COUNT + system] = start;
+    profile_data->system_time[sample * SYSTEM_COUNT + system] = end - start;
+}
 
-int main(int argc, char** argv) {
-}
\ No newline at end of file
+// with SHOOTER_THREADS, tick can run system_graph on a thread pool
+// every thread has a queue of systems that are ready,
+// it takes the newest from its own and steals the oldest from the others,
+// a finished system readies the dependents it was the last wait of
+// without it, or with one thread, the systems run in enum Systems order
+#ifdef SHOOTER_THREADS
+#define MAX_SYSTEM_THREADS 8
+struct System_Queue {
+    pthread_mutex_t lock;
+    // head is the oldest, it's where others steal from
+    uint head;
+    uint tail;
+    uint items[SYSTEM_COUNT];
+};
+struct System_Scheduler {
+    // including the main thread, which is thread 0
+    uint thread_count;
+    pthread_t threads[MAX_SYSTEM_THREADS];
+    struct System_Queue queues[MAX_SYSTEM_THREADS];
+    atomic_uint waiting_for[SYSTEM_COUNT];
+    atomic_uint finished_count;
+    float delta;
+    uint sample;
+    // like physics_workers
+    pthread_barrier_t start;
+    pthread_barrier_t done;
+    bool quit;
+    struct Thread_Gate gate;
+};
+struct System_Scheduler system_scheduler = {
+    .thread_count = 1,
+    .gate = THREAD_GATE_INIT,
+};
+
+void push_system(struct System_Queue* queue, uint system) {
+    pthread_mutex_lock(&queue->lock);
+    queue->items[queue->tail] = system;
+    queue->tail += 1;
+    pthread_mutex_unlock(&queue->lock);
+}
+// SYSTEM_COUNT when the queue is empty
+uint pop_system(struct System_Queue* queue, bool steal) {
+    uint system = SYSTEM_COUNT;
+    pthread_mutex_lock(&queue->lock);
+    if (queue->head < queue->tail) {
+        if (steal) {
+            system = queue->items[queue->head];
+            queue->head += 1;
+        }
+        else {
+            queue->tail -= 1;
+            system = queue->items[queue->tail];
+        }
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return system;
+}
+void run_system_graph_thread(uint thread) {
+    struct System_Scheduler* scheduler = &system_scheduler;
+    const struct System_Graph* graph = &system_graph;
+    while (atomic_load(&scheduler->finished_count) < SYSTEM_COUNT) {
+        uint system = pop_system(&scheduler->queues[thread], false);
+        for (uint k = 1; k < scheduler->thread_count && system == SYSTEM_COUNT; k += 1) {
+            system = pop_system(&scheduler->queues[(thread + k) % scheduler->thread_count], true);
+        }
+        // the systems left are waiting on ones that are running
+        if (system == SYSTEM_COUNT) {
+            sched_yield();
+            continue;
+        }
+        run_profiled_system(system, scheduler->delta, scheduler->sample);
+        for (uint k = 0; k < graph->dependent_count[system]; k += 1) {
+            const uint dependent = graph->dependents[system * SYSTEM_COUNT + k];
+            if (atomic_fetch_sub(&scheduler->waiting_for[dependent], 1) == 1) {
+                push_system(&scheduler->queues[thread], dependent);
+            }
+        }
+        atomic_fetch_add(&scheduler->finished_count, 1);
+    }
+}
+void* run_system_thread(void* thread) {
+    if (!pass_thread_gate(&system_scheduler.gate)) {
+        return NULL;
+    }
+    while (true) {
+        pthread_barrier_wait(&system_scheduler.start);
+        if (system_scheduler.quit) {
+            return NULL;
+        }
+        run_system_graph_thread((uintptr_t)thread);
+        pthread_barrier_wait(&system_scheduler.done);
+    }
+}
+void run_system_graph(float delta, uint sample) {
+    struct System_Scheduler* scheduler = &system_scheduler;
+    const struct System_Graph* graph = &system_graph;
+    scheduler->delta = delta;
+    scheduler->sample = sample;
+    atomic_store(&scheduler->finished_count, 0);
+    for (uint t = 0; t < scheduler->thread_count; t += 1) {
+        scheduler->queues[t].head = 0;
+        scheduler->queues[t].tail = 0;
+    }
+    // in reverse, so thread 0 takes the first one
+    for (uint system = SYSTEM_COUNT; system > 0; system -= 1) {
+        atomic_store(&scheduler->waiting_for[system - 1], graph->dependency_count[system - 1]);
+        if (graph->dependency_count[system - 1] == 0) {
+            push_system(&scheduler->queues[0], system - 1);
+        }
+    }
+    pthread_barrier_wait(&scheduler->start);
+    run_system_graph_thread(0);
+    pthread_barrier_wait(&scheduler->done);
+}
+#endif
+// 0 picks one per core
+// off by default, physics and ai_enemy take most of a tick and each runs alone,
+// so there's little to win yet
+// without SHOOTER_THREADS, or if the threads can't be started,
+// the systems run on the main thread
+EMSCRIPTEN_KEEPALIVE
+void set_system_thread_count(uint count) {
+#ifdef SHOOTER_THREADS
+    if (count == 0) {
+        const long core_count = sysconf(_SC_NPROCESSORS_ONLN);
+        count = core_count > 0 ? core_count : 1;
+    }
+    if (count > MAX_SYSTEM_THREADS) {
+        count = MAX_SYSTEM_THREADS;
+    }
+    struct System_Scheduler* scheduler = &system_scheduler;
+    if (scheduler->thread_count > 1) {
+        scheduler->quit = true;
+        pthread_barrier_wait(&scheduler->start);
+        for (uint t = 1; t < scheduler->thread_count; t += 1) {
+            pthread_join(scheduler->threads[t], NULL);
+        }
+        pthread_barrier_destroy(&scheduler->start);
+        pthread_barrier_destroy(&scheduler->done);
+        for (uint t = 0; t < scheduler->thread_count; t += 1) {
+            pthread_mutex_destroy(&scheduler->queues[t].lock);
+        }
+    }
+    scheduler->quit = false;
+    scheduler->thread_count = 1;
+    if (count <= 1) {
+        return;
+    }
+    uint locked = 0;
+    while (locked < count &&
+           pthread_mutex_init(&scheduler->queues[locked].lock, NULL) == 0) {
+        locked += 1;
+    }
+    if (locked < count) {
+        for (uint t = 0; t < locked; t += 1) {
+            pthread_mutex_destroy(&scheduler->queues[t].lock);
+        }
+        return;
+    }
+    if (pthread_barrier_init(&scheduler->start, NULL, count) != 0) {
+        for (uint t = 0; t < count; t += 1) {
+            pthread_mutex_destroy(&scheduler->queues[t].lock);
+        }
+        return;
+    }
+    if (pthread_barrier_init(&scheduler->done, NULL, count) != 0) {
+        pthread_barrier_destroy(&scheduler->start);
+        for (uint t = 0; t < count; t += 1) {
+            pthread_mutex_destroy(&scheduler->queues[t].lock);
+        }
+        return;
+    }
+    scheduler->gate.state = GATE_CLOSED;
+    uintptr_t started = 1;
+    while (started < count &&
+           pthread_create(&scheduler->threads[started], NULL, &run_system_thread, (void*)started) == 0) {
+        started += 1;
+    }
+    if (started < count) {
+        set_thread_gate(&scheduler->gate, GATE_GIVEN_UP);
+        for (uint t = 1; t < started; t += 1) {
+            pthread_join(scheduler->threads[t], NULL);
+        }
+        pthread_barrier_destroy(&scheduler->start);
+        pthread_barrier_destroy(&scheduler->done);
+        for (uint t = 0; t < count; t += 1) {
+            pthread_mutex_destroy(&scheduler->queues[t].lock);
+        }
+        return;
+    }
+    scheduler->thread_count = count;
+    set_thread_gate(&scheduler->gate, GATE_OPEN);
+#endif
+}
+EMSCRIPTEN_KEEPALIVE
+uint get_system_thread_count() {
+#ifdef SHOOTER_THREADS
+    return system_scheduler.thread_count;
+#else
+    return 1;
+#endif
+}
+
+// grows a table until count more items fit
+bool reserve_table_items(void* table_ptr, size_t count) {
+    struct Table* table = (struct Table*)table_ptr;
+    while (table->curr_max + count > table->max_count) {
+        if (!grow_table(table)) {
+            return false;
+        }
+    }
+    return true;
+}
+// makes room for every item the systems of a tick can add,
+// so none of them grows a table while others run
+// a tick creates one bullet and one zombie at most,
+// and each hit is a hit feedback item, one for the player and one per bullet
+// returns false if there's no memory, and the tick runs the systems one after another
+bool reserve_tick_capacity() {
+    while (entity_table->curr_max + 2 > entity_table->max_count) {
+        if (!grow_entity_table()) {
+            return false;
+        }
+    }
+    return reserve_table_items(physics_states, 2) &&
+           reserve_table_items(physics_balls, 2) &&
+           reserve_table_items(sprite_map, 2) &&
+           reserve_table_items(bullets, 1) &&
+           reserve_table_items(ai_enemy, 1) &&
+           reserve_table_items(health_table, 1) &&
+           reserve_table_items(proximity_attack, 1) &&
+           reserve_table_items(hit_feedback_table, bullets->curr_max + 1);
+}
+void run_systems_in_order(float delta) {
+    if (!profile_data->enabled) {
+        for (size_t system = 0; system < SYSTEM_COUNT; system += 1) {
+            run_system(system, delta);
+        }
+        return;
+    }
+
+    // a system can grow a table, which moves the arena,
+    // so the sample is indexed through profile_data every time
+    const uint sample = profile_data->next_sample;
+    double start = profile_now();
+    profile_data->tick_start[sample] = start;
+    for (size_t system = 0; system < SYSTEM_COUNT; system += 1) {
+        run_system(system, delta);
+        const double end = profile_now();
+        profile_data->system_start[sample * SYSTEM_COUNT + system] = start;
+        profile_data->system_time[sample * SYSTEM_COUNT + system] = end - start;
+        start = end;
+    }
+    profile_data->next_sample = (sample + 1) % PROFILE_SAMPLE_COUNT;
+    profile_data->total_samples += 1;
+}
+#ifdef SHOOTER_THREADS
+void run_systems_side_by_side(float delta) {
+    const uint sample = profile_data->enabled ? profile_data->next_sample : NO_PROFILE_SAMPLE;
+    if (profile_data->enabled) {
+        profile_data->tick_start[sample] = profile_now();
+    }
+    run_system_graph(delta, sample);
+    if (profile_data->enabled) {
+        profile_data->next_sample = (sample + 1) % PROFILE_SAMPLE_COUNT;
+        profile_data->total_samples += 1;
+    }
+}
+#endif
+void run_tick(float delta) {
+    timespec_add_float(&curr_time, delta);
+#ifdef SHOOTER_THREADS
+    if (system_scheduler.thread_count > 1 && reserve_tick_capacity()) {
+        run_systems_side_by_side(delta);
+    }
+    else {
+        run_systems_in_order(delta);
+    }
+#else
+    run_systems_in_order(delta);
+#endif
+    // the wheel can grow here, nothing else is running
+    for (size_t system = 0; system < SYSTEM_COUNT; system += 1) {
+        place_queued_timers(&timer_queues[system]);
+    }
+}
+
+// a hash of the world after a tick, of the items in use and the wave state,
+// the same world always gives the same checksum
+uint64_t checksum_bytes(uint64_t hash, const void* data, size_t size) {
+    const unsigned char* bytes = data;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, &bytes[i], sizeof(uint64_t));
+        hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+        hash ^= hash >> 32;
+    }
+    for (; i < size; i += 1) {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+uint64_t checksum_table(uint64_t hash, const void* table_ptr) {
+    const struct Table* table = (const struct Table*)table_ptr;
+    hash = checksum_bytes(hash, &table->curr_max, sizeof(table->curr_max));
+    hash = checksum_bytes(hash, table->entity_id, table->curr_max * sizeof(table_id_t));
+    for (size_t c = 0; c < table->column_count; c += 1) {
+        hash = checksum_bytes(hash, *table->columns[c].data, table->curr_max * table->columns[c].item_size);
+    }
+    return hash;
+}
+uint64_t get_world_checksum() {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    hash = checksum_bytes(hash, &entity_table->curr_max, sizeof(entity_table->curr_max));
+    hash = checksum_bytes(hash, entity_table->components, entity_table->curr_max * sizeof(component_mask_t));
+    hash = checksum_bytes(hash, entity_table->generation, entity_table->curr_max * sizeof(table_id_t));
+    hash = checksum_table(hash, physics_states);
+    hash = checksum_table(hash, physics_balls);
+    hash = checksum_table(hash, proximity_attack);
+    hash = checksum_table(hash, hit_feedback_table);
+    hash = checksum_table(hash, sprite_map);
+    hash = checksum_table(hash, ai_enemy);
+    hash = checksum_table(hash, bullets);
+    hash = checksum_table(hash, health_table);
+    hash = checksum_bytes(hash, &timer_wheel->curr_max, sizeof(timer_wheel->curr_max));
+    hash = checksum_bytes(hash, timer_wheel->expire_at, timer_wheel->curr_max * sizeof(uint64_t));
+    hash = checksum_bytes(hash, weapon_states->firing_state, weapon_states->max_count * sizeof(float));
+    hash = checksum_bytes(hash, &score, sizeof(score));
+    hash = checksum_bytes(hash, &curr_wave, sizeof(curr_wave));
+    hash = checksum_bytes(hash, &random_state, sizeof(random_state));
+    hash = checksum_bytes(hash, wave_emitter.remaining, sizeof(wave_emitter.remaining));
+    hash = checksum_bytes(hash, wave_completion.remaining, sizeof(wave_completion.remaining));
+    hash = checksum_bytes(hash, &wave_rest.rest_state, sizeof(wave_rest.rest_state));
+    return hash;
+}
+
+// recording logs every tick, its delta, the input when it changed
+// and the checksum of the world after it,
+// replaying feeds them back and compares the checksums,
+// see `start_recording` and `start_replay`
+enum Recorder_Mode {
+    RECORDER_OFF,
+    RECORDER_RECORDING,
+    RECORDER_REPLAYING,
+};
+#define NO_TICK ((size_t)-1)
+struct Tick_Record {
+    float delta;
+    // the Input_State follows when it's true
+    uint input_changed;
+    uint64_t checksum;
+};
+struct Recorder {
+    enum Recorder_Mode mode;
+    FILE* file;
+    // the input of the last tick recorded or replayed
+    struct Input_State input;
+    size_t tick_count;
+    // every tick's checksum folded together, one number for the whole run
+    uint64_t checksum;
+    // the first replayed tick whose checksum doesn't match the recording
+    size_t divergent_tick;
+};
+struct Recorder recorder = {.mode = RECORDER_OFF};
+// stops recording if the file can't be written
+void record_tick(float delta) {
+    struct Recorder* rec = &recorder;
+    struct Tick_Record record;
+    record.delta = delta;
+    record.input_changed = rec->tick_count == 0 ||
+                           memcmp(&rec->input, input_state, sizeof(struct Input_State)) != 0;
+    record.checksum = get_world_checksum();
+    bool ok = fwrite(&record, sizeof(record), 1, rec->file) == 1;
+    if (record.input_changed) {
+        rec->input = *input_state;
+        ok = ok && fwrite(&rec->input, sizeof(struct Input_State), 1, rec->file) == 1;
+    }
+    rec->checksum = checksum_bytes(rec->checksum, &record.checksum, sizeof(record.checksum));
+    rec->tick_count += 1;
+    if (!ok) {
+        printf("recording stopped, can't write\n");
+        fclose(rec->file);
+        rec->file = NULL;
+        rec->mode = RECORDER_OFF;
+    }
+}
+
+// see `set_rollback_length`
+bool is_rollback_on();
+void run_rollback_tick(float delta);
+void tick(float delta) {
+    if (is_rollback_on()) {
+        run_rollback_tick(delta);
+    }
+    else {
+        run_tick(delta);
+    }
+    if (recorder.mode == RECORDER_RECORDING) {
+        record_tick(delta);
+    }
+}
+
+// everything render() needs for one sprite, already joined and interpolated
+// every field is 4 bytes, so JS can read the list
+// through one Float32Array and one Uint32Array
+struct Draw_Item {
+    float x;
+    float y;
+    float angle;
+    float sprite_origin_x;
+    float sprite_origin_y;
+    float sprite_size;
+    // 0 when the entity isn't flashing
+    float hit_feedback_alpha;
+    uint sprite_id;
+    uint sprite_variant;
+};
+// items are sized by sprite_map->max_count, so they grow with it
+struct Draw_List {
+    size_t max_count;
+    size_t count;
+    struct Draw_Item* items;
+};
+struct Draw_List* draw_list;
+void alloc_draw_list(size_t max_count) {
+    draw_list = malloc(sizeof(struct Draw_List));
+    draw_list->max_count = max_count;
+    draw_list->count = 0;
+    arena_request_scratch(&draw_list->items, sizeof(struct Draw_Item), &sprite_map->max_count);
+}
+EMSCRIPTEN_KEEPALIVE
+struct Draw_List* get_draw_list() {
+    return draw_list;
+}
+float lerp(float a, float b, float t) {
+    return a + (b - a) * t;
+}
+// takes the short way around the circle
+float lerp_angle(float a, float b, float t) {
+    float delta = fmodf(b - a, M_PI * 2);
+    if (delta > M_PI) {
+        delta -= M_PI * 2;
+    }
+    if (delta < -M_PI) {
+        delta += M_PI * 2;
+    }
+    return a + delta * t;
+}
+// sprites that are off screen are left out
+void build_draw_list() {
+    const float t = tick_interpolation;
+    draw_list->max_count = sprite_map->max_count;
+    draw_list->count = 0;
+    for (table_id_t i = 0; i < sprite_map->curr_max; i += 1) {
+        const table_id_t entity_id = sprite_map->entity_id[i];
+        const table_id_t physics_id = find_item_index(physics_states, entity_id);
+        if (physics_id >= physics_states->curr_max) {
+            continue;
+        }
+        const float x = lerp(physics_states->prev_x[physics_id], physics_states->x[physics_id], t);
+        const float y = lerp(physics_states->prev_y[physics_id], physics_states->y[physics_id], t);
+        // rotated, the sprite reaches at most its size away from the entity
+        const float reach = sprite_map->sprite_size[i] + fabsf(sprite_map->sprite_origin_x[i]) +
+                                                         fabsf(sprite_map->sprite_origin_y[i]);
+        if (x + reach < 0 || x - reach > screen_width ||
+            y + reach < 0 || y - reach > screen_height) {
+            continue;
+        }
+
+        struct Draw_Item* item = &draw_list->items[draw_list->count];
+        draw_list->count += 1;
+        item->x = x;
+        item->y = y;
+        item->angle = lerp_angle(physics_states->prev_angle[physics_id], physics_states->angle[physics_id], t);
+        item->sprite_origin_x = sprite_map->sprite_origin_x[i];
+        item->sprite_origin_y = sprite_map->sprite_origin_y[i];
+        item->sprite_size = sprite_map->sprite_size[i];
+        item->sprite_id = sprite_map->sprite_id[i];
+        item->sprite_variant = sprite_map->sprite_variant[i];
+        item->hit_feedback_alpha = 0;
+        // most sprites have no hit feedback,
+        // so we only join the ones that do
+        if (has_components(entity_id, COMPONENT_HIT_FEEDBACK)) {
+            const table_id_t hit_feedback_id = find_item_index(hit_feedback_table, entity_id);
+            if (hit_feedback_id < hit_feedback_table->curr_max) {
+                item->hit_feedback_alpha = get_hit_feedback_amount(hit_feedback_id) / 100;
+            }
+        }
+    }
+}
+
+// world snapshots
+// a snapshot is the arena as it is in memory,
+// after a header, the layout of every arena request,
+// and the counts and wave state that live outside the arena
+// the counts give every request its size again,
+// so loading is pointing each request into the file, nothing is parsed
+// natively the file is mapped, copy on write, so pages load as they're touched
+// snapshots only load into the build that saved them,
+// a different version, layout or word size is refused
+#define SNAPSHOT_MAGIC "SHOOTSNP"
+#define SNAPSHOT_VERSION 2
+// where the arena starts in the file, so it can be mapped
+#define SNAPSHOT_PAGE_SIZE 4096
+#define SNAPSHOT_TABLE_COUNT 8
+struct Snapshot_Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t state_size;
+    uint32_t request_count;
+    uint64_t arena_offset;
+    uint64_t arena_size;
+};
+// per arena request, in request order
+struct Snapshot_Request {
+    uint64_t offset;
+    uint64_t size;
+    uint64_t item_size;
+};
+struct Snapshot_Table {
+    size_t max_count;
+    size_t curr_max;
+    table_id_t first_free;
+};
+// everything of the world that isn't in the arena
+// the scratch of the systems (physics_grid, ai_field, draw_list) is rebuilt every tick
+struct Snapshot_State {
+    size_t max_entity_count;
+    int screen_width;
+    int screen_height;
+    struct timespec curr_time;
+    struct Snapshot_Table entities;
+    struct Snapshot_Table tables[SNAPSHOT_TABLE_COUNT];
+    struct Snapshot_Table timers;
+    uint64_t timer_now;
+    size_t collision_max_count;
+    size_t collision_count;
+    size_t collision_bucket_count;
+    size_t command_count;
+    size_t weapon_max_count;
+    size_t weapon_curr_max;
+    int curr_weapon;
+    size_t campaign_max_count;
+    size_t campaign_curr_max;
+    size_t curr_wave;
+    uint score;
+    uint64_t random_state;
+    struct Wave_Emitter wave_emitter;
+    struct Wave_Rest wave_rest;
+    struct Wave_Completion wave_completion;
+    struct Overlay_Data overlay;
+};
+void get_snapshot_tables(struct Table* tables[SNAPSHOT_TABLE_COUNT]) {
+    tables[0] = (struct Table*)physics_states;
+    tables[1] = (struct Table*)physics_balls;
+    tables[2] = (struct Table*)proximity_attack;
+    tables[3] = (struct Table*)hit_feedback_table;
+    tables[4] = (struct Table*)sprite_map;
+    tables[5] = (struct Table*)ai_enemy;
+    tables[6] = (struct Table*)bullets;
+    tables[7] = (struct Table*)health_table;
+}
+void save_snapshot_state(struct Snapshot_State* state) {
+    memset(state, 0, sizeof(struct Snapshot_State));
+    state->max_entity_count = max_entity_count;
+    state->screen_width = screen_width;
+    state->screen_height = screen_height;
+    state->curr_time = curr_time;
+    state->entities.max_count = entity_table->max_count;
+    state->entities.curr_max = entity_table->curr_max;
+    state->entities.first_free = entity_table->first_free;
+    struct Table* tables[SNAPSHOT_TABLE_COUNT];
+    get_snapshot_tables(tables);
+    for (size_t t = 0; t < SNAPSHOT_TABLE_COUNT; t += 1) {
+        state->tables[t].max_count = tables[t]->max_count;
+        state->tables[t].curr_max = tables[t]->curr_max;
+        state->tables[t].first_free = tables[t]->first_free;
+    }
+    state->timers.max_count = timer_wheel->max_count;
+    state->timers.curr_max = timer_wheel->curr_max;
+    state->timers.first_free = timer_wheel->first_free;
+    state->timer_now = timer_wheel->now;
+    state->collision_max_count = collision_table->max_count;
+    state->collision_count = collision_table->count;
+    state->collision_bucket_count = collision_table->bucket_count;
+    state->command_count = command_buffer->count;
+    state->weapon_max_count = weapon_states->max_count;
+    state->weapon_curr_max = weapon_states->curr_max;
+    state->curr_weapon = curr_weapon;
+    state->campaign_max_count = campaign->max_count;
+    state->campaign_curr_max = campaign->curr_max;
+    state->curr_wave = curr_wave;
+    state->score = score;
+    state->random_state = random_state;
+    state->wave_emitter = wave_emitter;
+    state->wave_rest = wave_rest;
+    state->wave_completion = wave_completion;
+    state->overlay = *overlay_data;
+}
+void load_snapshot_state(const struct Snapshot_State* state) {
+    max_entity_count = state->max_entity_count;
+    screen_width = state->screen_width;
+    screen_height = state->screen_height;
+    curr_time = state->curr_time;
+    entity_table->max_count = state->entities.max_count;
+    entity_table->curr_max = state->entities.curr_max;
+    entity_table->first_free = state->entities.first_free;
+    struct Table* tables[SNAPSHOT_TABLE_COUNT];
+    get_snapshot_tables(tables);
+    for (size_t t = 0; t < SNAPSHOT_TABLE_COUNT; t += 1) {
+        tables[t]->max_count = state->tables[t].max_count;
+        tables[t]->curr_max = state->tables[t].curr_max;
+        tables[t]->first_free = state->tables[t].first_free;
+    }
+    timer_wheel->max_count = state->timers.max_count;
+    timer_wheel->curr_max = state->timers.curr_max;
+    timer_wheel->first_free = state->timers.first_free;
+    timer_wheel->now = state->timer_now;
+    collision_table->max_count = state->collision_max_count;
+    collision_table->count = state->collision_count;
+    collision_table->bucket_count = state->collision_bucket_count;
+    command_buffer->count = state->command_count;
+    weapon_states->max_count = state->weapon_max_count;
+    weapon_states->curr_max = state->weapon_curr_max;
+    curr_weapon = state->curr_weapon;
+    campaign->max_count = state->campaign_max_count;
+    campaign->curr_max = state->campaign_curr_max;
+    curr_wave = state->curr_wave;
+    score = state->score;
+    random_state = state->random_state;
+    wave_emitter = state->wave_emitter;
+    wave_rest = state->wave_rest;
+    wave_completion = state->wave_completion;
+    *overlay_data = state->overlay;
+}
+size_t get_snapshot_arena_offset() {
+    const size_t offset = sizeof(struct Snapshot_Header) +
+                          arena.request_count * sizeof(struct Snapshot_Request) +
+                          sizeof(struct Snapshot_State);
+    return (offset + SNAPSHOT_PAGE_SIZE - 1) & ~(size_t)(SNAPSHOT_PAGE_SIZE - 1);
+}
+EMSCRIPTEN_KEEPALIVE
+bool save_world(const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        return false;
+    }
+    struct Snapshot_Header header;
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.header_size = sizeof(struct Snapshot_Header);
+    header.state_size = sizeof(struct Snapshot_State);
+    header.request_count = arena.request_count;
+    header.arena_offset = get_snapshot_arena_offset();
+    header.arena_size = arena.size;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (size_t r = 0; r < arena.request_count && ok; r += 1) {
+        const struct Arena_Request* request = &arena.requests[r];
+        struct Snapshot_Request saved;
+        saved.offset = (char*)*request->ptr - arena.data;
+        saved.size = request->size;
+        saved.item_size = request->item_size;
+        ok = fwrite(&saved, sizeof(saved), 1, file) == 1;
+    }
+    struct Snapshot_State state;
+    save_snapshot_state(&state);
+    ok = ok && fwrite(&state, sizeof(state), 1, file) == 1;
+    ok = ok && fseek(file, header.arena_offset, SEEK_SET) == 0;
+    ok = ok && fwrite(arena.data, 1, arena.size, file) == arena.size;
+    ok = fclose(file) == 0 && ok;
+    return ok;
+}
+void reset_rollback();
+// the snapshot in data becomes the arena, base is what arena_release is given
+// leaves the world as it was if the snapshot doesn't fit this build
+bool restore_world(char* base, size_t mapped_size, char* data, size_t size) {
+    const struct Snapshot_Header* header = (const struct Snapshot_Header*)data;
+    if (size < sizeof(struct Snapshot_Header) ||
+        memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != SNAPSHOT_VERSION ||
+        header->header_size != sizeof(struct Snapshot_Header) ||
+        header->state_size != sizeof(struct Snapshot_State) ||
+        header->request_count != arena.request_count ||
+        header->arena_offset != get_snapshot_arena_offset() ||
+        header->arena_offset + header->arena_size > size) {
+
+        return false;
+    }
+    const struct Snapshot_Request* saved = (const struct Snapshot_Request*)(data + sizeof(struct Snapshot_Header));
+    const struct Snapshot_State* state = (const struct Snapshot_State*)(saved + arena.request_count);
+
+    struct Snapshot_State old_state;
+    save_snapshot_state(&old_state);
+    load_snapshot_state(state);
+    // the counts we just loaded must give the saved layout
+    size_t offset = 0;
+    for (size_t r = 0; r < arena.request_count; r += 1) {
+        const struct Arena_Request* request = &arena.requests[r];
+        if (saved[r].item_size != request->item_size ||
+            saved[r].size != get_request_size(request) ||
+            saved[r].offset != offset) {
+
+            load_snapshot_state(&old_state);
+            return false;
+        }
+        offset += arena_align(saved[r].size);
+    }
+    if (offset != header->arena_size) {
+        load_snapshot_state(&old_state);
+        return false;
+    }
+
+    arena_release(arena.base, arena.mapped_size);
+    arena.base = base;
+    arena.mapped_size = mapped_size;
+    arena.data = data + header->arena_offset;
+    arena.size = header->arena_size;
+    for (size_t r = 0; r < arena.request_count; r += 1) {
+        struct Arena_Request* request = &arena.requests[r];
+        request->size = saved[r].size;
+        *request->ptr = arena.data + saved[r].offset;
+    }
+    // the frame in progress belongs to the old world
+    tick_accumulator = 0;
+    draw_list->max_count = sprite_map->max_count;
+    draw_list->count = 0;
+    // and so do the ticks we could go back to
+    reset_rollback();
+    struct Table* tables[SNAPSHOT_TABLE_COUNT];
+    get_snapshot_tables(tables);
+    for (size_t t = 0; t < SNAPSHOT_TABLE_COUNT; t += 1) {
+        fit_table_changes(tables[t]);
+    }
+    fit_row_marks(&entity_marks, max_entity_count);
+    fit_row_marks(&timer_wheel->marks, timer_wheel->max_count);
+    mark_all_changed();
+    return true;
+}
+// the world is as it was when the snapshot was saved,
+// its capacities too
+EMSCRIPTEN_KEEPALIVE
+bool load_world(const char* path) {
+#ifndef __EMSCRIPTEN__
+    const int file = open(path, O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+    struct stat file_stat;
+    if (fstat(file, &file_stat) != 0 || file_stat.st_size == 0) {
+        close(file);
+        return false;
+    }
+    const size_t size = file_stat.st_size;
+    char* data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED) {
+        return false;
+    }
+    if (!restore_world(data, size, data, size)) {
+        munmap(data, size);
+        return false;
+    }
+    return true;
+#else
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    // read so the arena lands aligned
+    char* base = malloc(size + ARENA_ALIGNMENT - 1);
+    if (size <= 0 || base == NULL) {
+        free(base);
+        fclose(file);
+        return false;
+    }
+    char* data = (char*)(((uintptr_t)base + ARENA_ALIGNMENT - 1) & ~(uintptr_t)(ARENA_ALIGNMENT - 1));
+    const bool read = fread(data, 1, size, file) == (size_t)size;
+    fclose(file);
+    if (!read || !restore_world(base, 0, data, size)) {
+        free(base);
+        return false;
+    }
+    return true;
+#endif
+}
+
+#define RECORDING_MAGIC "SHOOTREC"
+#define RECORDING_VERSION 1
+// after the snapshot's arena
+struct Recording_Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t input_size;
+    uint64_t random_state;
+};
+void stop_recorder() {
+    if (recorder.file != NULL) {
+        fclose(recorder.file);
+    }
+    recorder.file = NULL;
+    recorder.mode = RECORDER_OFF;
+}
+// the file starts as a snapshot of the world, see `save_world`,
+// so a replay starts from where the recording did
+EMSCRIPTEN_KEEPALIVE
+bool start_recording(const char* path) {
+    stop_recorder();
+    if (!save_world(path)) {
+        return false;
+    }
+    recorder.file = fopen(path, "ab");
+    if (recorder.file == NULL) {
+        return false;
+    }
+    struct Recording_Header header;
+    memcpy(header.magic, RECORDING_MAGIC, sizeof(header.magic));
+    header.version = RECORDING_VERSION;
+    header.input_size = sizeof(struct Input_State);
+    header.random_state = random_state;
+    if (fwrite(&header, sizeof(header), 1, recorder.file) != 1) {
+        stop_recorder();
+        return false;
+    }
+    recorder.mode = RECORDER_RECORDING;
+    recorder.tick_count = 0;
+    recorder.checksum = 0;
+    recorder.divergent_tick = NO_TICK;
+    return true;
+}
+EMSCRIPTEN_KEEPALIVE
+void stop_recording() {
+    if (recorder.mode == RECORDER_RECORDING) {
+        stop_recorder();
+    }
+}
+// loads the world the recording started from
+// while replaying, step plays one recorded tick per frame, see `replay_tick`
+EMSCRIPTEN_KEEPALIVE
+bool start_replay(const char* path) {
+    stop_recorder();
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return false;
+    }
+    struct Snapshot_Header snapshot;
+    struct Recording_Header header;
+    if (fread(&snapshot, sizeof(snapshot), 1, file) != 1 ||
+        fseek(file, snapshot.arena_offset + snapshot.arena_size, SEEK_SET) != 0 ||
+        fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, RECORDING_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != RECORDING_VERSION ||
+        header.input_size != sizeof(struct Input_State) ||
+        !load_world(path)) {
+
+        fclose(file);
+        return false;
+    }
+    random_state = header.random_state;
+    recorder.file = file;
+    recorder.mode = RECORDER_REPLAYING;
+    recorder.tick_count = 0;
+    recorder.checksum = 0;
+    recorder.divergent_tick = NO_TICK;
+    return true;
+}
+// false when the recording has ended
+EMSCRIPTEN_KEEPALIVE
+bool replay_tick() {
+    struct Recorder* rec = &recorder;
+    if (rec->mode != RECORDER_REPLAYING) {
+        return false;
+    }
+    struct Tick_Record record;
+    if (fread(&record, sizeof(record), 1, rec->file) != 1 ||
+        (record.input_changed && fread(&rec->input, sizeof(struct Input_State), 1, rec->file) != 1)) {
+
+        stop_recorder();
+        return false;
+    }
+    *input_state = rec->input;
+    run_tick(record.delta);
+    const uint64_t checksum = get_world_checksum();
+    if (checksum != record.checksum && rec->divergent_tick == NO_TICK) {
+        rec->divergent_tick = rec->tick_count;
+        printf("replay diverged at tick %zu\n", rec->tick_count);
+    }
+    rec->checksum = checksum_bytes(rec->checksum, &checksum, sizeof(checksum));
+    rec->tick_count += 1;
+    return true;
+}
+// -1 while the replay matches the recording
+EMSCRIPTEN_KEEPALIVE
+int get_replay_divergent_tick() {
+    return recorder.divergent_tick == NO_TICK ? -1 : (int)recorder.divergent_tick;
+}
+
+// rollback keeps the last few ticks in memory, so we can go back to one
+// and run the ticks after it again, with other input, see `rollback_to_tick`
+// after every tick, the columns are compared with a copy of them as of the tick before,
+// in chunks, and the old contents of the chunks that changed are kept,
+// with the counts and wave state the tick started from
+// going back a tick is copying its chunks back and loading its counts
+// only the rows marked written are compared, see `struct Row_Marks`,
+// so a tick costs what it wrote, and keeps what it changed
+// the few arrays without marks have their rows in use compared
+// the systems' scratch space isn't kept, every tick rebuilds it
+#define ROLLBACK_CHUNK_SIZE 64
+struct Rollback_Chunk {
+    uint32_t request;
+    // in ROLLBACK_CHUNK_SIZE bytes from the start of the request
+    uint32_t chunk;
+    unsigned char data[ROLLBACK_CHUNK_SIZE];
+};
+struct Rollback_Tick {
+    float delta;
+    struct Input_State input;
+    // the counts and wave state before the tick
+    struct Snapshot_State state;
+    // the chunks the tick changed, as they were before it
+    struct Rollback_Chunk* chunks;
+    size_t chunk_count;
+    size_t max_chunk_count;
+};
+struct Rollback {
+    // how many ticks we can go back, 0 is off
+    size_t length;
+    // tick t is at t % length
+    struct Rollback_Tick* ticks;
+    // ticks run since rollback was turned on, the world is as it was after this many
+    size_t tick;
+    // the furthest back we can go
+    size_t first_tick;
+    // ticks in [tick, redo_tick) were gone back over and can run again,
+    // until a new tick is run, see `resimulate_ticks`
+    size_t redo_tick;
+    // per arena request, the world as of the last tick,
+    // with arena_align(size) bytes, and the used bytes then
+    unsigned char* shadow[MAX_ARENA_REQUESTS];
+    size_t shadow_size[MAX_ARENA_REQUESTS];
+    size_t shadow_used[MAX_ARENA_REQUESTS];
+};
+struct Rollback rollback = {.length = 0};
+bool is_rollback_on() {
+    return rollback.length > 0;
+}
+// the bytes of the request the world uses, in whole chunks
+size_t get_rollback_used_size(const struct Arena_Request* request) {
+    size_t size = request->size;
+    if (request->used_count != NULL && *request->used_count * request->item_size < size) {
+        size = *request->used_count * request->item_size;
+    }
+    return (size + ROLLBACK_CHUNK_SIZE - 1) & ~(size_t)(ROLLBACK_CHUNK_SIZE - 1);
+}
+void free_rollback() {
+    for (size_t t = 0; t < rollback.length; t += 1) {
+        free(rollback.ticks[t].chunks);
+    }
+    free(rollback.ticks);
+    for (size_t r = 0; r < MAX_ARENA_REQUESTS; r += 1) {
+        free(rollback.shadow[r]);
+        rollback.shadow[r] = NULL;
+        rollback.shadow_size[r] = 0;
+    }
+    rollback.ticks = NULL;
+    rollback.length = 0;
+}
+// the marks of requests that share them are cleared more than once, which is fine
+void clear_rollback_marks() {
+    for (size_t r = 0; r < arena.request_count; r += 1) {
+        if (arena.requests[r].marks != NULL) {
+            clear_row_marks(arena.requests[r].marks);
+        }
+    }
+}
+// keeps up to length ticks, from the world as it is now
+// 0 turns rollback off, returns false if there's no memory
+EMSCRIPTEN_KEEPALIVE
+bool set_rollback_length(uint length) {
+    free_rollback();
+    rollback.tick = 0;
+    rollback.first_tick = 0;
+    rollback.redo_tick = 0;
+    clear_rollback_marks();
+    if (length == 0) {
+        return true;
+    }
+    rollback.ticks = calloc(length, sizeof(struct Rollback_Tick));
+    if (rollback.ticks == NULL) {
+        return false;
+    }
+    rollback.length = length;
+    for (size_t r = 0; r < arena.request_count; r += 1) {
+        const struct Arena_Request* request = &arena.requests[r];
+        if (request->scratch) {
+            continue;
+        }
+        const size_t size = arena_align(request->size);
+        rollback.shadow[r] = malloc(size);
+        if (rollback.shadow[r] == NULL) {
+            free_rollback();
+            return false;
+        }
+        memcpy(rollback.shadow[r], *request->ptr, size);
+        rollback.shadow_size[r] = size;
+        rollback.shadow_used[r] = get_rollback_used_size(request);
+    }
+    return true;
+}
+// the world changed under us, we start over from it
+void reset_rollback() {
+    if (rollback.length > 0) {
+        set_rollback_length(rollback.length);
+    }
+}
+EMSCRIPTEN_KEEPALIVE
+uint get_rollback_length() {
+    return rollback.length;
+}
+// the tick the world is at, counting from when rollback was turned on
+EMSCRIPTEN_KEEPALIVE
+size_t get_rollback_tick() {
+    return rollback.tick;
+}
+// the furthest back `rollback_to_tick` can go
+EMSCRIPTEN_KEEPALIVE
+size_t get_rollback_first_tick() {
+    return rollback.first_tick;
+}
+
+bool push_rollback_chunk(struct Rollback_Tick* entry, uint32_t request, uint32_t chunk, const unsigned char* data) {
+    if (entry->chunk_count == entry->max_chunk_count) {
+        const size_t max_chunk_count = entry->max_chunk_count == 0 ? 64 : entry->max_chunk_count * 2;
+        struct Rollback_Chunk* chunks = realloc(entry->chunks, max_chunk_count * sizeof(struct Rollback_Chunk));
+        if (chunks == NULL) {
+            return false;
+        }
+        entry->chunks = chunks;
+        entry->max_chunk_count = max_chunk_count;
+    }
+    struct Rollback_Chunk* item = &entry->chunks[entry->chunk_count];
+    item->request = request;
+    item->chunk = chunk;
+    memcpy(item->data, data, ROLLBACK_CHUNK_SIZE);
+    entry->chunk_count += 1;
+    return true;
+}
+// keeps the chunk at offset of request r in entry if it changed, and brings the shadow up to date
+bool save_rollback_chunk(struct Rollback_Tick* entry, size_t r, size_t offset) {
+    const unsigned char* data = *arena.requests[r].ptr;
+    unsigned char* shadow = rollback.shadow[r];
+    if (memcmp(&data[offset], &shadow[offset], ROLLBACK_CHUNK_SIZE) == 0) {
+        return true;
+    }
+    if (!push_rollback_chunk(entry, r, offset / ROLLBACK_CHUNK_SIZE, &shadow[offset])) {
+        return false;
+    }
+    memcpy(&shadow[offset], &data[offset], ROLLBACK_CHUNK_SIZE);
+    return true;
+}
+// keeps what changed since the last tick in entry, and brings the shadow up to date
+bool save_rollback_chunks(struct Rollback_Tick* entry) {
+    entry->chunk_count = 0;
+    for (size_t r = 0; r < arena.request_count; r += 1) {
+        const struct Arena_Request* request = &arena.requests[r];
+        if (request->scratch) {
+            continue;
+        }
+        // the arena grew, the new items are zeroed
+        const size_t size = arena_align(request->size);
+        if (size > rollback.shadow_size[r]) {
+            unsigned char* shadow = realloc(rollback.shadow[r], size);
+            if (shadow == NULL) {
+                return false;
+            }
+            memset(shadow + rollback.shadow_size[r], 0, size - rollback.shadow_size[r]);
+            rollback.shadow[r] = shadow;
+            rollback.shadow_size[r] = size;
+        }
+        const size_t used = get_rollback_used_size(request);
+        const struct Row_Marks* marks = request->marks;
+        if (marks != NULL && !marks->all) {
+            // rows the tick stopped using were marked when they were emptied
+            // rows are mostly marked in order, so the chunk just compared is skipped
+            size_t compared = SIZE_MAX;
+            for (size_t m = 0; m < marks->count; m += 1) {
+                const size_t start = (size_t)marks->rows[m] * request->item_size;
+                const size_t end = start + request->item_size;
+                for (size_t offset = start & ~(size_t)(ROLLBACK_CHUNK_SIZE - 1); offset < end;
+                     offset += ROLLBACK_CHUNK_SIZE) {
+
+                    if (offset == compared) {
+                        continue;
+                    }
+                    if (!save_rollback_chunk(entry, r, offset)) {
+                        return false;
+                    }
+                    compared = offset;
+                }
+            }
+        }
+        else {
+            // rows the tick stopped using changed too
+            const size_t end = used > rollback.shadow_used[r] ? used : rollback.shadow_used[r];
+            for (size_t offset = 0; offset < end; offset += ROLLBACK_CHUNK_SIZE) {
+                if (!save_rollback_chunk(entry, r, offset)) {
+                    return false;
+                }
+            }
+        }
+        rollback.shadow_used[r] = used;
+    }
+    clear_rollback_marks();
+    return true;
+}
+// capacities only grow, and the arena is laid out for the current ones,
+// the scratch counts belong to the scratch, which isn't gone back over
+void load_rollback_state(const struct Snapshot_State* state) {
+    struct Snapshot_State current;
+    save_snapshot_state(&current);
+    struct Snapshot_State loaded = *state;
+    loaded.max_entity_count = current.max_entity_count;
+    loaded.screen_width = current.screen_width;
+    loaded.screen_height = current.screen_height;
+    loaded.entities.max_count = current.entities.max_count;
+    for (size_t t = 0; t < SNAPSHOT_TABLE_COUNT; t += 1) {
+        loaded.tables[t].max_count = current.tables[t].max_count;
+    }
+    loaded.timers.max_count = current.timers.max_count;
+    loaded.collision_max_count = current.collision_max_count;
+    loaded.collision_count = current.collision_count;
+    loaded.collision_bucket_count = current.collision_bucket_count;
+    loaded.command_count = current.command_count;
+    loaded.weapon_max_count = current.weapon_max_count;
+    loaded.campaign_max_count = current.campaign_max_count;
+    load_snapshot_state(&loaded);
+}
+void undo_rollback_tick(const struct Rollback_Tick* entry) {
+    for (size_t c = 0; c < entry->chunk_count; c += 1) {
+        const struct Rollback_Chunk* item = &entry->chunks[c];
+        const size_t offset = (size_t)item->chunk * ROLLBACK_CHUNK_SIZE;
+        memcpy((char*)*arena.requests[item->request].ptr + offset, item->data, ROLLBACK_CHUNK_SIZE);
+        memcpy(rollback.shadow[item->request] + offset, item->data, ROLLBACK_CHUNK_SIZE);
+    }
+    load_rollback_state(&entry->state);
+}
+// tick, keeping what it changes
+// turns rollback off if there's no memory
+void run_rollback_tick(float delta) {
+    if (rollback.tick - rollback.first_tick == rollback.length) {
+        rollback.first_tick += 1;
+    }
+    struct Rollback_Tick* entry = &rollback.ticks[rollback.tick % rollback.length];
+    entry->delta = delta;
+    entry->input = *input_state;
+    save_snapshot_state(&entry->state);
+    run_tick(delta);
+    if (!save_rollback_chunks(entry)) {
+        printf("rollback turned off, out of memory\n");
+        set_rollback_length(0);
+        return;
+    }
+    rollback.tick += 1;
+    rollback.redo_tick = rollback.tick;
+}
+// the world becomes what it was after tick,
+// the ticks after it can be run again with `resimulate_ticks`
+// not while recording or replaying, the recording would no longer match
+EMSCRIPTEN_KEEPALIVE
+bool rollback_to_tick(size_t tick) {
+    if (rollback.length == 0 || recorder.mode != RECORDER_OFF ||
+        tick < rollback.first_tick || tick > rollback.tick) {
+
+        return false;
+    }
+    if (rollback.redo_tick < rollback.tick) {
+        rollback.redo_tick = rollback.tick;
+    }
+    while (rollback.tick > tick) {
+        rollback.tick -= 1;
+        undo_rollback_tick(&rollback.ticks[rollback.tick % rollback.length]);
+    }
+    // the chunks don't say which rows they were
+    mark_all_changed();
+    for (size_t r = 0; r < arena.request_count; r += 1) {
+        if (!arena.requests[r].scratch) {
+            rollback.shadow_used[r] = get_rollback_used_size(&arena.requests[r]);
+        }
+    }
+    return true;
+}
+// the current input becomes the input of a tick that was gone back over,
+// for when the input we predicted turns out wrong
+EMSCRIPTEN_KEEPALIVE
+bool set_rollback_input(size_t tick) {
+    if (rollback.length == 0 || tick < rollback.tick || tick >= rollback.redo_tick) {
+        return false;
+    }
+    rollback.ticks[tick % rollback.length].input = *input_state;
+    return true;
+}
+// runs up to count of the ticks that were gone back over, with their delta and input,
+// returns how many ran
+EMSCRIPTEN_KEEPALIVE
+size_t resimulate_ticks(size_t count) {
+    const struct Input_State input = *input_state;
+    size_t tick_count = 0;
+    while (tick_count < count && rollback.length > 0 && rollback.tick < rollback.redo_tick) {
+        const size_t redo_tick = rollback.redo_tick;
+        const struct Rollback_Tick* entry = &rollback.ticks[rollback.tick % rollback.length];
+        *input_state = entry->input;
+        run_rollback_tick(entry->delta);
+        rollback.redo_tick = redo_tick;
+        tick_count += 1;
+    }
+    *input_state = input;
+    return tick_count;
+}
+
+// the rows of a table that changed since a frame, see `struct Table_Changes`
+// every field JS reads is 4 bytes
+struct Table_Delta {
+    // the frame to ask from next time
+    uint frame;
+    // every row is in the delta, the frame asked from was too long ago,
+    // or the world was loaded or rolled back since
+    uint full;
+    uint changed_count;
+    uint removed_count;
+    // the changed entities, then the removed ones
+    table_id_t* entity_id;
+    // per column of the table, the items of the changed entities, in entity_id order
+    void* columns[MAX_TABLE_COLUMNS];
+    // holds entity_id and columns
+    char* data;
+    size_t data_size;
+    // the entities of the frames, once each
+    table_id_t* listed;
+    size_t max_listed;
+    // per entity slot, the export that listed the slot last and the entity it listed,
+    // so an entity changed in many frames is listed once
+    uint* listed_at;
+    table_id_t* listed_id;
+    size_t listed_slot_count;
+    uint export_count;
+};
+struct Table_Delta table_delta;
+bool reserve_table_delta(size_t max_listed) {
+    struct Table_Delta* delta = &table_delta;
+    if (max_listed > delta->max_listed) {
+        table_id_t* listed = realloc(delta->listed, max_listed * sizeof(table_id_t));
+        if (listed == NULL) {
+            return false;
+        }
+        delta->listed = listed;
+        delta->max_listed = max_listed;
+    }
+    if (max_entity_count > delta->listed_slot_count) {
+        uint* listed_at = realloc(delta->listed_at, max_entity_count * sizeof(uint));
+        if (listed_at == NULL) {
+            return false;
+        }
+        delta->listed_at = listed_at;
+        table_id_t* listed_id = realloc(delta->listed_id, max_entity_count * sizeof(table_id_t));
+        if (listed_id == NULL) {
+            return false;
+        }
+        delta->listed_id = listed_id;
+        memset(&listed_at[delta->listed_slot_count], 0,
+               (max_entity_count - delta->listed_slot_count) * sizeof(uint));
+        delta->listed_slot_count = max_entity_count;
+    }
+    return true;
+}
+// lists the entities changed in [since_frame, change_frame), returns how many
+// false if there's no memory
+bool list_changed_entities(const struct Table_Changes* changes, size_t since_frame, size_t* count) {
+    struct Table_Delta* delta = &table_delta;
+    delta->export_count += 1;
+    if (delta->export_count == 0) {
+        memset(delta->listed_at, 0, delta->listed_slot_count * sizeof(uint));
+        delta->export_count = 1;
+    }
+    size_t max_listed = 0;
+    for (size_t f = since_frame; f < change_frame; f += 1) {
+        max_listed += changes->frames[f % CHANGE_FRAME_COUNT].count;
+    }
+    if (!reserve_table_delta(max_listed)) {
+        return false;
+    }
+    *count = 0;
+    for (size_t f = since_frame; f < change_frame; f += 1) {
+        const struct Change_Frame* frame = &changes->frames[f % CHANGE_FRAME_COUNT];
+        for (size_t e = 0; e < frame->count; e += 1) {
+            const table_id_t entity_id = frame->entity_id[e];
+            const table_id_t slot = get_entity_slot(entity_id);
+            if (slot >= delta->listed_slot_count) {
+                continue;
+            }
+            if (delta->listed_at[slot] == delta->export_count && delta->listed_id[slot] == entity_id) {
+                continue;
+            }
+            delta->listed_at[slot] = delta->export_count;
+            delta->listed_id[slot] = entity_id;
+            delta->listed[*count] = entity_id;
+            *count += 1;
+        }
+    }
+    return true;
+}
+// the rows that changed in the frames since since_frame, with the values they have now,
+// and the entities that left the table
+// pass 0 the first time, and the delta's frame after that
+// the delta is valid until the next export
+EMSCRIPTEN_KEEPALIVE
+struct Table_Delta* export_table_delta(void* table_ptr, uint since_frame) {
+    const struct Table* table = (const struct Table*)table_ptr;
+    struct Table_Delta* delta = &table_delta;
+    delta->frame = change_frame;
+    delta->full = since_frame > change_frame ||
+                  since_frame + CHANGE_FRAME_COUNT <= change_frame ||
+                  (since_frame <= all_changed_frame && all_changed_frame < change_frame);
+    delta->changed_count = 0;
+    delta->removed_count = 0;
+
+    size_t listed_count = 0;
+    if (!delta->full && !list_changed_entities(table->changes, since_frame, &listed_count)) {
+        delta->full = true;
+    }
+    if (delta->full) {
+        listed_count = 0;
+        if (!reserve_table_delta(table->curr_max)) {
+            return NULL;
+        }
+        for (table_id_t i = 0; i < table->curr_max; i += 1) {
+            if (table->used[i]) {
+                delta->listed[listed_count] = table->entity_id[i];
+                listed_count += 1;
+            }
+        }
+    }
+
+    // entity ids, then the columns, each on its own 8 bytes
+    size_t size = (listed_count * sizeof(table_id_t) + 7) & ~(size_t)7;
+    for (size_t c = 0; c < table->column_count; c += 1) {
+        size += (listed_count * table->columns[c].item_size + 7) & ~(size_t)7;
+    }
+    if (size > delta->data_size) {
+        char* data = realloc(delta->data, size);
+        if (data == NULL) {
+            return NULL;
+        }
+        delta->data = data;
+        delta->data_size = size;
+    }
+    delta->entity_id = (table_id_t*)delta->data;
+    // the removed entities are moved to the front of listed, which we've read past,
+    // and go after the changed ones at the end
+    // then listed has the rows of the changed ones
+    for (size_t e = 0; e < listed_count; e += 1) {
+        const table_id_t entity_id = delta->listed[e];
+        if (find_item_index((void*)table, entity_id) < table->curr_max) {
+            delta->entity_id[delta->changed_count] = entity_id;
+            delta->changed_count += 1;
+        }
+        else {
+            delta->listed[delta->removed_count] = entity_id;
+            delta->removed_count += 1;
+        }
+    }
+    memcpy(&delta->entity_id[delta->changed_count], delta->listed, delta->removed_count * sizeof(table_id_t));
+    for (size_t e = 0; e < delta->changed_count; e += 1) {
+        delta->listed[e] = find_item_index((void*)table, delta->entity_id[e]);
+    }
+
+    size_t offset = (listed_count * sizeof(table_id_t) + 7) & ~(size_t)7;
+    for (size_t c = 0; c < MAX_TABLE_COLUMNS; c += 1) {
+        delta->columns[c] = NULL;
+    }
+    for (size_t c = 0; c < table->column_count; c += 1) {
+        const size_t item_size = table->columns[c].item_size;
+        const char* column = *table->columns[c].data;
+        char* items = delta->data + offset;
+        for (size_t e = 0; e < delta->changed_count; e += 1) {
+            memcpy(items + e * item_size, column + delta->listed[e] * item_size, item_size);
+        }
+        delta->columns[c] = items;
+        offset += (listed_count * item_size + 7) & ~(size_t)7;
+    }
+    return delta;
+}
+// the frame the changes being marked belong to
+EMSCRIPTEN_KEEPALIVE
+uint get_change_frame() {
+    return change_frame;
+}
+// called by step after every frame,
+// headless drivers call it when they want to export
+EMSCRIPTEN_KEEPALIVE
+void end_change_frame() {
+    struct Table* tables[SNAPSHOT_TABLE_COUNT];
+    get_snapshot_tables(tables);
+    for (size_t t = 0; t < SNAPSHOT_TABLE_COUNT; t += 1) {
+        end_table_changes(tables[t]);
+    }
+    change_frame += 1;
+}
+
+EMSCRIPTEN_KEEPALIVE
+void step() {
+    const float delta = step_time();
+    if (recorder.mode == RECORDER_REPLAYING) {
+        replay_tick();
+        tick_interpolation = 1;
+        build_draw_list();
+        end_change_frame();
+        return;
+    }
+    if (!fixed_timestep) {
+        tick(delta);
+        tick_interpolation = 1;
+    }
+    else {
+        const float tick_delta = 1.0 / TICK_RATE;
+        tick_accumulator += delta;
+        size_t tick_count = 0;
+        while (tick_accumulator >= tick_delta && tick_count < MAX_CATCH_UP_TICKS) {
+            tick(tick_delta);
+            tick_accumulator -= tick_delta;
+            tick_count += 1;
+        }
+        // after a long frame we drop the time we can't catch up on,
+        // so one slow frame doesn't make the next ones slow too
+        if (tick_accumulator >= tick_delta) {
+            tick_accumulator = fmodf(tick_accumulator, tick_delta);
+        }
+        tick_interpolation = tick_accumulator / tick_delta;
+    }
+    build_draw_list();
+    end_change_frame();
+}
+
+#ifndef SHOOTER_NO_MAIN
+int main(int argc, char** argv) {
+}
+#endif
\ No newline at end of file